@@ -1,4 +1,5 @@
 #include <Dynamixel2Arduino.h>
+#include <PolarKinematics.h>
 #include <math.h>
 
 // Hardware setup: OpenRB-150
@@ -14,31 +15,27 @@ const uint8_t DXL_LEVER = 2;  // DXL_POLAR_ARM
 const uint8_t DXL_PLAT  = 3;  // DXL_PLATFORM
 
 // Geometry & homes - Updated to match new config
-const float R0        = 98.995f;                    // POLAR_ARM_LENGTH [mm]
+constexpr float R0    = 98.995f;                    // POLAR_ARM_LENGTH [mm]
 const float HOME_LEV  = (0.51f/360.0f*4096.0f);   // POLAR_ARM_HOME
 const float HOME_PLAT = 1238.0f;                   // PLATFORM_HOME
 
 // Platform center + radius
-const float Cx    = 70.0f;
-const float Cy    = 70.0f;
-const float Rplat = 45.0f;
+constexpr float Cx    = 70.0f;
+constexpr float Cy    = 70.0f;
+constexpr float Rplat = 45.0f;
+
+// Lever/platform inverse kinematics, geometry folded at compile time
+static constexpr PolarKinematics::Solver KINEMATICS(Cx, Cy, R0, Rplat);
 
 // Store the current motor positions to optimize movement
-float current_lever_angle = 0;  // in radians
-float current_platform_angle = 0;  // in radians
+PolarKinematics::angle_t current_lever_angle = 0;     // binary angle, 65536 = one turn
+PolarKinematics::angle_t current_platform_angle = 0;  // binary angle
 bool first_move = true;  // Flag for first movement
 
 // Extended position tracking for platform motor
 float cumulative_platform_degrees = 0;  // Track total rotation
 float last_platform_degrees = 0;        // Previous target in degrees
 
-// Standard deg2raw for lever (no discontinuity issues expected)
-uint16_t deg2raw(float deg) {
-  float d = fmod(deg, 360.0f);
-  if (d<0) d += 360.0f;
-  return uint16_t((d/360.0f)*4096.0f) & 0x0FFF;
-}
-
 // Extended position for platform motor to avoid discontinuities
 int32_t extendedPlatformPosition(float target_degrees) {
   // Calculate the angular difference
@@ -120,93 +117,31 @@ void waitForMotors() {
  * Using extended position control for platform to avoid discontinuities
  */
 bool drawPlatformPoint(float rx, float ry) {
-  // 1. Constrain to platform radius
-  float r = sqrt(rx*rx + ry*ry);
-  if (r > Rplat) {
-    rx = (Rplat/r) * rx;
-    ry = (Rplat/r) * ry;
-    DEBUG_SERIAL.println("Point constrained to platform radius");
-  }
-  
-  // Calculate original point angle in platform coordinates
-  float original_angle = atan2(ry, rx);
-  float platform_radius = sqrt(rx*rx + ry*ry);
-  
-  // Find the intersection of lever arc and platform distance
-  float center_dist = sqrt(Cx*Cx + Cy*Cy);
-  
-  // Check if circles can intersect
-  if (center_dist > R0 + platform_radius || center_dist < abs(R0 - platform_radius)) {
+  // Intersection of the lever arc and the circle the point sweeps as the
+  // platform turns (points outside the dish are constrained to its edge)
+  PolarKinematics::Solution solution;
+  if (KINEMATICS.solve(rx, ry, solution) != PolarKinematics::SOLVED) {
     DEBUG_SERIAL.println("No intersection possible - point cannot be reached");
     return false;
   }
-  
-  // Calculate parameters for intersection
-  float a = (R0*R0 - platform_radius*platform_radius + center_dist*center_dist) / (2.0f * center_dist);
-  float h = sqrt(R0*R0 - a*a);
-  
-  // Center point along the line between circle centers
-  float x2 = Cx * a / center_dist;
-  float y2 = Cy * a / center_dist;
-  
-  // Calculate both possible intersections
-  float intersection1_x = x2 + h * (-Cy) / center_dist;
-  float intersection1_y = y2 + h * Cx / center_dist;
-  
-  float intersection2_x = x2 - h * (-Cy) / center_dist;
-  float intersection2_y = y2 - h * Cx / center_dist;
-  
-  // Calculate lever angles for both solutions
-  float lever_angle1 = atan2(intersection1_y, intersection1_x);
-  float lever_angle2 = atan2(intersection2_y, intersection2_x);
-  
-  // Calculate intersection angles from platform center
-  float intersection1_angle_from_platform = atan2(intersection1_y - Cy, intersection1_x - Cx);
-  float intersection2_angle_from_platform = atan2(intersection2_y - Cy, intersection2_x - Cx);
-  
-  // Calculate platform angles for both solutions
-  float platform_angle1 = intersection1_angle_from_platform - original_angle;
-  float platform_angle2 = intersection2_angle_from_platform - original_angle;
-  
+
   // Choose the solution with the minimum movement from current position
-  float theta1, theta2;
-  float movement1, movement2;
-  
-  if (first_move) {
-    // For first move, prefer the solution with platform angle closer to 0
-    movement1 = abs(platform_angle1);
-    movement2 = abs(platform_angle2);
-    first_move = false;
-  } else {
-    // Calculate total angular distance for both solutions
-    movement1 = abs(lever_angle1 - current_lever_angle) + abs(platform_angle1 - current_platform_angle);
-    movement2 = abs(lever_angle2 - current_lever_angle) + abs(platform_angle2 - current_platform_angle);
-  }
-  
-  // Choose the solution with less movement
-  if (movement1 <= movement2) {
-    theta1 = lever_angle1;
-    theta2 = platform_angle1;
-  } else {
-    theta1 = lever_angle2;
-    theta2 = platform_angle2;
-  }
-  
+  uint8_t pick = PolarKinematics::chooseSolution(solution, current_lever_angle, current_platform_angle, first_move);
+  first_move = false;
+
   // Store current positions for next movement
-  current_lever_angle = theta1;
-  current_platform_angle = theta2;
-  
+  current_lever_angle = solution.lever[pick];
+  current_platform_angle = solution.platform[pick];
+
   // Convert to motor positions
-  // Lever: standard position control
-  float deg1 = fmod(degrees(theta1), 360.0f);
-  if (deg1 < 0) deg1 += 360.0f;
-  deg1 = deg1 + (HOME_LEV/4096.0f*360.0f);
-  
+  // Lever: standard position control, one turn of the binary angle
+  uint16_t raw1 = (PolarKinematics::toTicks((uint16_t)current_lever_angle) + (int32_t)(HOME_LEV + 0.5f)) & 0x0FFF;
+
   // Platform: extended position control to avoid discontinuities
-  float deg2 = degrees(theta2) + (HOME_PLAT/4096.0f*360.0f);
-  
+  float deg2 = PolarKinematics::toDegrees(current_platform_angle) + (HOME_PLAT/4096.0f*360.0f);
+
   // Set motor positions
-  dxl.setGoalPosition(DXL_LEVER, deg2raw(deg1));
+  dxl.setGoalPosition(DXL_LEVER, raw1);
   dxl.setGoalPosition(DXL_PLAT, extendedPlatformPosition(deg2));  // Use extended position
   
   waitForMotors();
@@ -1,6 +1,9 @@
 import serial
 import tkinter as tk
 import time
+import struct
+import os
+import subprocess
 
 
 class ORBobj:
@@ -52,4 +55,109 @@ class ORBobj:
 
     def liftAll(self,dir):
         self.write(f"LIFT ALL {dir}")
-        
\ No newline at end of file
+        
+
+    # Uploaded streak patterns (PATH command)
+    # points: list of (x, y) in mm, relative to the platform centre
+
+    PATH_UNITS_PER_MM = 100   # Must match PATH_UNITS_PER_MM in config.h
+    PATH_DATA_MAX_POINTS = 32 # Must match PATH_DATA_MAX_POINTS in config.h
+
+    def _waitFor(self, prefixes, timeout):
+        # Return the first line starting with one of prefixes, skipping debug output
+        end = time.time() + timeout
+        while time.time() < end:
+            line = self.read()
+            for prefix in prefixes:
+                if line.startswith(prefix):
+                    return line
+        raise TimeoutError(f"No {prefixes} from OpenRB")
+
+    def _pathData(self, points):
+        data = b"".join(struct.pack("<hh", round(x * self.PATH_UNITS_PER_MM), round(y * self.PATH_UNITS_PER_MM))
+                        for x, y in points)
+        return data.hex().upper()
+
+    def _beginPath(self, id):
+        self.write(f"PATH BEGIN {id}")
+        return int(self._waitFor(["PATH READY"], 5).split()[3])
+
+    def uploadPath(self, id, points):
+        # Store a pattern that fits the board's buffer; it can then be run by ID any number of times
+        credits = self._beginPath(id)
+        if len(points) > credits:
+            raise ValueError(f"Pattern has {len(points)} points, buffer holds {credits} - use streamPath")
+        for i in range(0, len(points), self.PATH_DATA_MAX_POINTS):
+            self.write("PATH DATA " + self._pathData(points[i:i + self.PATH_DATA_MAX_POINTS]))
+        self.write("PATH END")
+        line = self._waitFor(["PATH LOADED", "PATH INVALID", "PATH OVERFLOW"], 5)
+        if not line.startswith("PATH LOADED"):
+            raise RuntimeError(line)
+        return int(line.split()[3])
+
+    def runPath(self, id, timeout=120):
+        self.write(f"PATH RUN {id}")
+        return self._waitFor(["PATH COMPLETED", "PATH FAILED", "PATH UNKNOWN ID"], timeout) == "PATH COMPLETED"
+
+    def streamPath(self, id, points, timeout=120):
+        # Draw a pattern of any length, sending points as the board frees buffer slots
+        chunks = [(self._pathData(points[i:i + self.PATH_DATA_MAX_POINTS]),
+                   len(points[i:i + self.PATH_DATA_MAX_POINTS]))
+                  for i in range(0, len(points), self.PATH_DATA_MAX_POINTS)]
+        return self._streamChunks(f"PATH BEGIN {id}", id, chunks, timeout)
+
+    # Joint trajectories solved on the NUC (see StreakTrajectory/streaktraj.cpp)
+
+    STREAKTRAJ = os.path.join(os.path.dirname(os.path.abspath(__file__)), "StreakTrajectory", "streaktraj")
+
+    def solveTrajectory(self, id, *shape):
+        # e.g. solveTrajectory(0, "line", -40, 0, 40, 0, 60) -> PATH lines for streamTrajectory()
+        result = subprocess.run([self.STREAKTRAJ, str(id)] + [str(a) for a in shape],
+                                capture_output=True, text=True, check=True)
+        return result.stdout.split("\n")
+
+    def streamTrajectory(self, lines, timeout=120):
+        # Play a joint trajectory; the board does no inverse kinematics
+        lines = [line.strip() for line in lines if line.strip()]
+        begin = lines[0]
+        id = int(begin.split()[2])
+        chunks = [(line[len("PATH DATA "):], self._jointSteps(line[len("PATH DATA "):]))
+                  for line in lines if line.startswith("PATH DATA ")]
+        return self._streamChunks(begin, id, chunks, timeout)
+
+    @staticmethod
+    def _jointSteps(hex_data):
+        # Steps in one PATH DATA line: 2 bytes each, 5 after an 0x80 escape
+        data = bytes.fromhex(hex_data)
+        steps, pos = 0, 0
+        while pos < len(data):
+            pos += 5 if data[pos] == 0x80 else 2
+            steps += 1
+        return steps
+
+    def _streamChunks(self, begin, id, chunks, timeout):
+        # chunks: (hex payload, points or steps in it); each needs that many credits
+        self.write(begin)
+        credits = int(self._waitFor(["PATH READY"], 5).split()[3])
+        sent = 0
+
+        def fill():
+            nonlocal credits, sent
+            while sent < len(chunks) and credits >= chunks[sent][1]:
+                self.write("PATH DATA " + chunks[sent][0])
+                credits -= chunks[sent][1]
+                sent += 1
+            if sent == len(chunks):
+                self.write("PATH END")
+
+        fill()
+        self.write(f"PATH RUN {id}")
+        end = time.time() + timeout
+        while time.time() < end:
+            line = self.read()
+            if line.startswith("PATH CREDIT") and sent < len(chunks):
+                credits += int(line.split()[2])
+                fill()
+            elif line in ("PATH COMPLETED", "PATH FAILED", "PATH UNKNOWN ID"):
+                return line == "PATH COMPLETED"
+        raise TimeoutError("Pattern did not finish")
@@ -0,0 +1,333 @@
+/**
+ * @file StreakTrajectory.h
+ * @brief Host-side joint trajectory solver for the streaker (NUC)
+ *
+ * Solves a whole pattern to raw polar arm / platform goals on the host, the
+ * same way HardwareControl does on the OpenRB: same geometry
+ * (PetriStreakerSerial/Geometry.h), same fixed-point solver and branch
+ * planner (libraries/PolarKinematics). The result is delta-encoded into
+ * PATH JOINT / PATH DATA / PATH END lines, which the firmware plays without
+ * running the inverse kinematics itself. Points near the platform centre are
+ * left out; a segment that passes the centre gets its centre poses here
+ * (CenterPass.h), as the firmware would add them to points it solves.
+ *
+ * Header-only, C++11, no Arduino dependencies.
+ */
+
+#ifndef STREAK_TRAJECTORY_H
+#define STREAK_TRAJECTORY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include <PolarKinematics.h>
+#include <ChordSubdivision.h>
+#include <BranchPlanner.h>
+#include <CenterPass.h>
+#include "../../PetriStreakerSerial/Geometry.h"
+
+namespace StreakTrajectory {
+
+// PATH DATA payload limit: PATH_DATA_MAX_POINTS * 4 bytes (config.h)
+const size_t DATA_LINE_BYTES = 32 * 4;
+
+// Starting spans per turn for adaptive placement: CHORD_SEGMENTS_PER_TURN (config.h)
+const uint8_t CHORD_SEGMENTS_PER_TURN = 4;
+
+// Joint step that does not fit in two int8: escape byte, then two int16
+const uint8_t JOINT_ESCAPE = 0x80;
+
+static constexpr PolarKinematics::Solver KINEMATICS(PLATFORM_CENTER_X, PLATFORM_CENTER_Y, POLAR_ARM_LENGTH,
+                                                    PLATFORM_RADIUS, POINT_MIN_RADIUS);
+
+/**
+ * @brief One pattern point, platform-relative (mm)
+ */
+struct Point {
+  float x;
+  float y;
+};
+
+/**
+ * @brief Raw goals of one point, home applied, within one turn
+ */
+struct JointGoal {
+  uint16_t polar;
+  uint16_t platform;
+};
+
+// ============================================================================
+// PATTERN POINTS
+// ============================================================================
+// Same point sequences as HardwareControl::drawLine(), drawCircle(),
+// drawSpiral() and drawFlower() - fixed sampling here, or chordPoints() for
+// the adaptive placement the board uses when CHORD_TOLERANCE_MM > 0.
+
+inline std::vector<Point> line(float x1, float y1, float x2, float y2, int num_points = 20) {
+  std::vector<Point> points;
+  num_points = num_points < 2 ? 2 : num_points;
+  for (int i = 0; i < num_points; i++) {
+    float t = (float)i / (num_points - 1);
+    points.push_back(Point{x1 + t * (x2 - x1), y1 + t * (y2 - y1)});
+  }
+  return points;
+}
+
+inline std::vector<Point> circle(float radius, int num_points = 36) {
+  std::vector<Point> points;
+  for (int i = 0; i < num_points; i++) {
+    float angle = (2.0f * (float)M_PI * i) / num_points;
+    points.push_back(Point{radius * cosf(angle), radius * sinf(angle)});
+  }
+  return points;
+}
+
+inline std::vector<Point> spiral(float max_radius, float revolutions, int num_points = 50) {
+  std::vector<Point> points;
+  for (int i = 0; i < num_points; i++) {
+    float t = (float)i / (num_points - 1);
+    float angle = -t * revolutions * 2.0f * (float)M_PI;
+    float radius = t * max_radius;
+    points.push_back(Point{radius * cosf(angle), radius * sinf(angle)});
+  }
+  return points;
+}
+
+inline std::vector<Point> flower(float radius, float amplitude, int petals, int num_points = 50) {
+  std::vector<Point> points;
+  for (int i = 0; i < num_points; i++) {
+    float angle = (2.0f * (float)M_PI * i) / num_points;
+    float r = radius + amplitude * sinf(petals * angle);
+    points.push_back(Point{r * cosf(angle), r * sinf(angle)});
+  }
+  return points;
+}
+
+struct PointSink {
+  std::vector<Point>* points;
+  void point(float x, float y) {
+    points->push_back(Point{x, y});
+  }
+};
+
+/**
+ * @brief Points of a curve placed for a chord tolerance (see ChordSubdivision.h)
+ */
+template <class Curve>
+std::vector<Point> chordPoints(const Curve& curve, float tolerance, uint8_t segments) {
+  std::vector<Point> points;
+  PointSink sink = {&points};
+  PolarKinematics::subdivideChords(KINEMATICS, curve, tolerance, segments, sink);
+  return points;
+}
+
+// ============================================================================
+// SOLVER
+// ============================================================================
+
+/**
+ * @brief Result of solving a whole pattern
+ */
+struct Trajectory {
+  std::vector<JointGoal> goals;  // Drawn points and centre poses, in order
+  size_t skipped;                // Points near the centre, left out as on the board
+  size_t unreachable;            // Points outside the arm's reach, left out
+  size_t center_passes;          // Segments drawn through the centre
+};
+
+/**
+ * @brief Branch choice, as BRANCH_PLAN_MODE (config.h)
+ */
+enum BranchMode {
+  BRANCH_GREEDY,  // Per point, against the previous point only
+  BRANCH_TOTAL,   // Whole pattern: least total joint travel
+  BRANCH_PEAK     // Whole pattern: smallest largest step, then least travel
+};
+
+class Planner {
+  public:
+    explicit Planner(BranchMode mode = BRANCH_TOTAL)
+      : mode(mode), first_move(true), current_lever(0), current_platform(0) {}
+
+    /**
+     * @brief Forget the current pose - the next point picks its branch fresh
+     */
+    void reset() {
+      first_move = true;
+    }
+
+    /**
+     * @brief One point, as HardwareControl::solvePlatformPoint()
+     */
+    PolarKinematics::Result solve(const Point& point, JointGoal& goal) {
+      PolarKinematics::Solution solution;
+      PolarKinematics::Result result = KINEMATICS.solve(point.x, point.y, solution);
+      if (result != PolarKinematics::SOLVED) {
+        return result;
+      }
+
+      uint8_t pick = PolarKinematics::chooseSolution(solution, current_lever, current_platform, first_move);
+      goal = poseGoal(solution.lever[pick], solution.platform[pick]);
+      return PolarKinematics::SOLVED;
+    }
+
+    /**
+     * @brief Every point of a pattern, starting from a fresh branch choice
+     *
+     * Greedy mode solves point by point like solve(); the others plan the
+     * branches over the whole pattern first (planBranches(), up to 65535
+     * points), as the firmware does between beginPlan() and endPlan().
+     */
+    Trajectory solvePattern(const std::vector<Point>& points) {
+      Trajectory trajectory = Trajectory();
+      reset();
+      if (mode == BRANCH_GREEDY) {
+        for (size_t i = 0; i < points.size(); i++) {
+          PolarKinematics::Solution solution;
+          PolarKinematics::Result result = KINEMATICS.solve(points[i].x, points[i].y, solution);
+          if (result == PolarKinematics::SOLVED) {
+            uint8_t pick = PolarKinematics::chooseSolution(solution, current_lever, current_platform, first_move);
+            addPose(trajectory, solution.lever[pick], solution.platform[pick]);
+          } else {
+            skip(trajectory, result);
+          }
+        }
+        return trajectory;
+      }
+
+      std::vector<PolarKinematics::PlanPoint> plan(points.size());
+      for (size_t i = 0; i < points.size(); i++) {
+        PolarKinematics::Solution solution;
+        PolarKinematics::Result result = KINEMATICS.solve(points[i].x, points[i].y, solution);
+        PolarKinematics::setPlanPoint(plan[i], result, solution);
+      }
+      PolarKinematics::planBranches(plan.data(), (uint16_t)plan.size(),
+                                    mode == BRANCH_PEAK ? PolarKinematics::PLAN_PEAK_STEP
+                                                        : PolarKinematics::PLAN_TOTAL_TRAVEL,
+                                    false, 0, 0);
+
+      for (size_t i = 0; i < plan.size(); i++) {
+        const PolarKinematics::PlanPoint& point = plan[i];
+        if (point.result == PolarKinematics::SOLVED) {
+          addPose(trajectory, point.lever[point.pick], point.platform[point.pick]);
+        } else {
+          skip(trajectory, (PolarKinematics::Result)point.result);
+        }
+      }
+      return trajectory;
+    }
+
+  private:
+    BranchMode mode;
+    bool first_move;
+    PolarKinematics::angle_t current_lever;
+    PolarKinematics::angle_t current_platform;
+
+    // Raw goals of a chosen pose, which becomes the current one
+    JointGoal poseGoal(PolarKinematics::angle_t lever, PolarKinematics::angle_t platform) {
+      first_move = false;
+      current_lever = lever;
+      current_platform = platform;
+
+      JointGoal goal;
+      goal.polar = (PolarKinematics::toTicks((uint16_t)lever) + POLAR_ARM_HOME_TICKS) & 0x0FFF;
+      goal.platform = (PolarKinematics::toTicks((uint16_t)platform) + PLATFORM_HOME_TICKS) & 0x0FFF;
+      return goal;
+    }
+
+    // A drawn pose, after the centre poses of the segment from the current one
+    void addPose(Trajectory& trajectory, PolarKinematics::angle_t lever, PolarKinematics::angle_t platform) {
+      PolarKinematics::CenterPass pass;
+      if (!first_move && PolarKinematics::centerPass(KINEMATICS, current_lever, current_platform, lever, platform,
+                                                     CENTER_PASS_RADIUS, pass)) {
+        JointGoal in = poseGoal(pass.lever, pass.platform_in);
+        JointGoal out = poseGoal(pass.lever, pass.platform_out);
+        trajectory.goals.push_back(in);
+        if (out.platform != in.platform) {
+          trajectory.goals.push_back(out);
+        }
+        trajectory.center_passes++;
+      }
+      trajectory.goals.push_back(poseGoal(lever, platform));
+    }
+
+    static void skip(Trajectory& trajectory, PolarKinematics::Result result) {
+      if (result == PolarKinematics::NEAR_CENTER) {
+        trajectory.skipped++;
+      } else {
+        trajectory.unreachable++;
+      }
+    }
+};
+
+// ============================================================================
+// ENCODING
+// ============================================================================
+
+/**
+ * @brief Shortest step between two raw goals within one turn, [-2048, 2047]
+ */
+inline int16_t wrapStep(uint16_t from, uint16_t to) {
+  return (int16_t)(((to - from + 2048) & 0x0FFF) - 2048);
+}
+
+inline void appendHex(std::string& out, uint8_t byte) {
+  static const char digits[] = "0123456789ABCDEF";
+  out += digits[byte >> 4];
+  out += digits[byte & 0x0F];
+}
+
+/**
+ * @brief PATH JOINT / PATH DATA / PATH END lines for a solved trajectory
+ *
+ * The first goal is the origin and is drawn as a zero step; every goal after
+ * it is the step from the previous one, one byte per axis when it fits.
+ */
+inline std::vector<std::string> encode(uint8_t id, const std::vector<JointGoal>& goals) {
+  std::vector<std::string> lines;
+  if (goals.empty()) {
+    return lines;
+  }
+
+  char header[48];
+  snprintf(header, sizeof(header), "PATH JOINT %u %u %u", id, goals[0].polar, goals[0].platform);
+  lines.push_back(header);
+
+  std::string data;
+  size_t bytes = 0;
+  JointGoal previous = goals[0];
+  for (size_t i = 0; i < goals.size(); i++) {
+    int16_t polar = wrapStep(previous.polar, goals[i].polar);
+    int16_t platform = wrapStep(previous.platform, goals[i].platform);
+    previous = goals[i];
+
+    bool small = polar > -128 && polar < 128 && platform >= -128 && platform < 128;
+    size_t size = small ? 2 : 5;
+    if (bytes + size > DATA_LINE_BYTES) {
+      lines.push_back("PATH DATA " + data);
+      data.clear();
+      bytes = 0;
+    }
+    if (small) {
+      appendHex(data, (uint8_t)polar);
+      appendHex(data, (uint8_t)platform);
+    } else {
+      appendHex(data, JOINT_ESCAPE);
+      appendHex(data, (uint8_t)(polar & 0xFF));
+      appendHex(data, (uint8_t)((uint16_t)polar >> 8));
+      appendHex(data, (uint8_t)(platform & 0xFF));
+      appendHex(data, (uint8_t)((uint16_t)platform >> 8));
+    }
+    bytes += size;
+  }
+  lines.push_back("PATH DATA " + data);
+  lines.push_back("PATH END");
+  return lines;
+}
+
+}  // namespace StreakTrajectory
+
+#endif // STREAK_TRAJECTORY_H
@@ -0,0 +1,113 @@
+/**
+ * @file streaktraj.cpp
+ * @brief Command-line front end of StreakTrajectory.h
+ *
+ * Prints the PATH lines of a joint trajectory for the OpenRB; ORBobj's
+ * streamTrajectory() sends them with flow control.
+ *
+ * Build (from this directory):
+ *   g++ -std=c++11 -O2 -I../../libraries/PolarKinematics/src streaktraj.cpp -o streaktraj
+ *
+ * Usage:
+ *   streaktraj [options] <id> line <x1> <y1> <x2> <y2> [points]
+ *   streaktraj [options] <id> circle <radius> [points]
+ *   streaktraj [options] <id> spiral <max_radius> <revolutions> [points]
+ *   streaktraj [options] <id> flower <radius> <amplitude> <petals> [points]
+ *   streaktraj [options] <id> points < file   (one "x y" pair in mm per line)
+ *
+ * Options:
+ *   -c <mm>    Place the points adaptively for this chord tolerance, as the
+ *              firmware does with CHORD_TOLERANCE_MM ([points] is ignored)
+ *   -b <mode>  Branch choice: total (default), peak or greedy, as BRANCH_PLAN_MODE
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "StreakTrajectory.h"
+
+using namespace StreakTrajectory;
+
+static void usage() {
+  fprintf(stderr,
+          "usage: streaktraj [options] <id> line <x1> <y1> <x2> <y2> [points]\n"
+          "       streaktraj [options] <id> circle <radius> [points]\n"
+          "       streaktraj [options] <id> spiral <max_radius> <revolutions> [points]\n"
+          "       streaktraj [options] <id> flower <radius> <amplitude> <petals> [points]\n"
+          "       streaktraj [options] <id> points < file\n"
+          "options: -c <mm>    chord tolerance (adaptive points)\n"
+          "         -b <mode>  branch choice: total, peak or greedy\n");
+}
+
+// Numeric argument i, or fallback if it was not given
+static float arg(int argc, char** argv, int i, float fallback) {
+  return i < argc ? (float)atof(argv[i]) : fallback;
+}
+
+int main(int argc, char** argv) {
+  float chord = 0;
+  BranchMode branches = BRANCH_TOTAL;
+  while (argc > 2 && argv[1][0] == '-') {
+    if (strcmp(argv[1], "-c") == 0) {
+      chord = (float)atof(argv[2]);
+    } else if (strcmp(argv[1], "-b") == 0 && strcmp(argv[2], "total") == 0) {
+      branches = BRANCH_TOTAL;
+    } else if (strcmp(argv[1], "-b") == 0 && strcmp(argv[2], "peak") == 0) {
+      branches = BRANCH_PEAK;
+    } else if (strcmp(argv[1], "-b") == 0 && strcmp(argv[2], "greedy") == 0) {
+      branches = BRANCH_GREEDY;
+    } else {
+      usage();
+      return 2;
+    }
+    argc -= 2;
+    argv += 2;
+  }
+  if (argc < 3) {
+    usage();
+    return 2;
+  }
+  uint8_t id = (uint8_t)atoi(argv[1]);
+  const char* shape = argv[2];
+
+  std::vector<Point> points;
+  if (strcmp(shape, "line") == 0 && argc >= 7) {
+    PolarKinematics::LineCurve curve = {arg(argc, argv, 3, 0), arg(argc, argv, 4, 0), arg(argc, argv, 5, 0),
+                                        arg(argc, argv, 6, 0)};
+    points = chord > 0 ? chordPoints(curve, chord, 1)
+                       : line(curve.x1, curve.y1, curve.x2, curve.y2, (int)arg(argc, argv, 7, 20));
+  } else if (strcmp(shape, "circle") == 0 && argc >= 4) {
+    PolarKinematics::CircleCurve curve = {arg(argc, argv, 3, 0)};
+    points = chord > 0 ? chordPoints(curve, chord, CHORD_SEGMENTS_PER_TURN)
+                       : circle(curve.radius, (int)arg(argc, argv, 4, 36));
+  } else if (strcmp(shape, "spiral") == 0 && argc >= 5) {
+    PolarKinematics::SpiralCurve curve = {arg(argc, argv, 3, 0), arg(argc, argv, 4, 0)};
+    int segments = (int)ceilf(curve.revolutions * CHORD_SEGMENTS_PER_TURN);
+    points = chord > 0 ? chordPoints(curve, chord, (uint8_t)(segments < 1 ? 1 : segments > 255 ? 255 : segments))
+                       : spiral(curve.max_radius, curve.revolutions, (int)arg(argc, argv, 5, 50));
+  } else if (strcmp(shape, "flower") == 0 && argc >= 6) {
+    PolarKinematics::FlowerCurve curve = {arg(argc, argv, 3, 0), arg(argc, argv, 4, 0), (int)arg(argc, argv, 5, 0)};
+    int segments = CHORD_SEGMENTS_PER_TURN * (curve.petals < 1 ? 1 : curve.petals);
+    points = chord > 0 ? chordPoints(curve, chord, (uint8_t)(segments > 255 ? 255 : segments))
+                       : flower(curve.radius, curve.amplitude, curve.petals, (int)arg(argc, argv, 6, 50));
+  } else if (strcmp(shape, "points") == 0) {
+    Point point;
+    while (scanf("%f %f", &point.x, &point.y) == 2) {
+      points.push_back(point);
+    }
+  } else {
+    usage();
+    return 2;
+  }
+
+  Planner planner(branches);
+  Trajectory trajectory = planner.solvePattern(points);
+  std::vector<std::string> lines = encode(id, trajectory.goals);
+  for (size_t i = 0; i < lines.size(); i++) {
+    printf("%s\n", lines[i].c_str());
+  }
+
+  fprintf(stderr, "%zu points: %zu goals, %zu skipped near the centre, %zu centre passes, %zu unreachable, %zu lines\n",
+          points.size(), trajectory.goals.size(), trajectory.skipped, trajectory.center_passes, trajectory.unreachable,
+          lines.size());
+  return trajectory.unreachable > 0 ? 1 : 0;
+}
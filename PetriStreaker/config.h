@@ -31,9 +31,14 @@
 // Geometry & homes (in raw units, 0–4095)
 #define LID_LIFTER_HOME   3849.0f
 #define POLAR_ARM_LENGTH   98.995f  // Polar arm length [mm]
+#define PLATFORM_CENTER_X  70.0f   // Platform center relative to the arm pivot [mm]
+#define PLATFORM_CENTER_Y  70.0f
+#define PLATFORM_RADIUS    45.0f   // Points further out are constrained to the dish edge [mm]
 #define POLAR_ARM_HOME    (56.25f/360.0f*4096.0f)  // DO NOT MODIFY USEFUL FOR CALCULATIONS - DO NOT GO THERE
+#define POLAR_ARM_HOME_TICKS ((int32_t)(POLAR_ARM_HOME + 0.5f))
 #define POLAR_ARM_NO_OBSTRUCT_HOME (236.25f/360.0f*4096.0f) // ACTUAL POSITION TO RES      T
 #define PLATFORM_HOME     1238.0f  // Platform home position to not obstruct 
+#define PLATFORM_HOME_TICKS ((int32_t)(PLATFORM_HOME + 0.5f))
 #define HANDLER_HOME      1947.0f  // Platform home position means that it goes to cartridge. Middle is 1705 units 2112. New is 1540 so 407 units
 #define RESTACKER_HOME    2669.0f  // Restacker position down
 #define CARTRIDGE1_HOME   0.0f     // C1 position down
@@ -13,21 +13,20 @@
 // Global hardware instance
 HardwareControl hardware;
 
+// Lever/platform inverse kinematics, geometry folded at compile time
+static constexpr PolarKinematics::Solver KINEMATICS(PLATFORM_CENTER_X, PLATFORM_CENTER_Y, POLAR_ARM_LENGTH,
+                                                    PLATFORM_RADIUS);
+
 /**
  * @brief Constructor - Initialize hardware control object
  * 
  * Sets up initial values for position tracking and platform geometry.
  */
 HardwareControl::HardwareControl() : dxl(DXL_SERIAL, DXL_DIR_PIN) {
-  current_polar_angle = 0.0f;
-  current_platform_angle = 0.0f;
+  current_polar_angle = 0;
+  current_platform_angle = 0;
   is_initialized = false;
   first_move = true;
-  
-  // Platform geometry settings
-  platform_center_x = 70.0f;  // Cx
-  platform_center_y = 70.0f;  // Cy
-  platform_radius = 45.0f;    // Rplat
 }
 
 /**
@@ -147,8 +146,8 @@ void HardwareControl::homeAllAxes() {
   waitForMotors();
   
   // Reset current positions
-  current_polar_angle = 0.0f;
-  current_platform_angle = 0.0f;
+  current_polar_angle = 0;
+  current_platform_angle = 0;
   first_move = true;
   
   DEBUG_SERIAL.println("All axes homed");
@@ -384,141 +383,48 @@ bool HardwareControl::homePosition() {
 }
 
 bool HardwareControl::drawPlatformPoint(float rx, float ry) {
-  // 1. Constrain to platform radius
-  float r = sqrt(rx*rx + ry*ry);
-  if (r > platform_radius) {
-    rx = (platform_radius/r) * rx;
-    ry = (platform_radius/r) * ry;
-    DEBUG_SERIAL.println("Point constrained to platform radius");
-  }
-  
   // Print platform-relative coordinates
   DEBUG_SERIAL.print("Platform coordinates: (");
   DEBUG_SERIAL.print(rx);
   DEBUG_SERIAL.print(", ");
   DEBUG_SERIAL.print(ry);
   DEBUG_SERIAL.println(")");
-  
-  // Calculate original point angle in platform coordinates
-  float original_angle = atan2(ry, rx);
-  float platform_radius_point = sqrt(rx*rx + ry*ry);
-  
-  DEBUG_SERIAL.print("Platform radius: ");
-  DEBUG_SERIAL.println(platform_radius_point);
-  
-  // Find the intersection of:
-  // 1. Circle with radius POLAR_ARM_LENGTH centered at origin (lever's reach)
-  // 2. Circle with radius 'platform_radius_point' centered at platform center
-  
-  // Distance between circle centers
-  float center_dist = sqrt(platform_center_x*platform_center_x + platform_center_y*platform_center_y);
-  
-  // Check if circles can intersect
-  if (center_dist > POLAR_ARM_LENGTH + platform_radius_point || 
-      center_dist < abs(POLAR_ARM_LENGTH - platform_radius_point)) {
+
+  // Intersection of the lever's reach with the circle the point sweeps as
+  // the platform turns (points outside the dish are constrained to its edge)
+  PolarKinematics::Solution solution;
+  if (KINEMATICS.solve(rx, ry, solution) != PolarKinematics::SOLVED) {
     DEBUG_SERIAL.println("No intersection possible - point cannot be reached");
     return false;
   }
-  
-  // Calculate parameters for intersection
-  float a = (POLAR_ARM_LENGTH*POLAR_ARM_LENGTH - platform_radius_point*platform_radius_point + center_dist*center_dist) / (2.0f * center_dist);
-  float h = sqrt(POLAR_ARM_LENGTH*POLAR_ARM_LENGTH - a*a);
-  
-  // Center point along the line between circle centers
-  float x2 = platform_center_x * a / center_dist;
-  float y2 = platform_center_y * a / center_dist;
-  
-  // Calculate both possible intersections
-  float intersection1_x = x2 + h * (-platform_center_y) / center_dist;
-  float intersection1_y = y2 + h * platform_center_x / center_dist;
-  
-  float intersection2_x = x2 - h * (-platform_center_y) / center_dist;
-  float intersection2_y = y2 - h * platform_center_x / center_dist;
-  
-  // Calculate lever angles for both solutions
-  float lever_angle1 = atan2(intersection1_y, intersection1_x);
-  float lever_angle2 = atan2(intersection2_y, intersection2_x);
-  
-  // Calculate intersection angles from platform center
-  float intersection1_angle_from_platform = atan2(intersection1_y - platform_center_y, 
-                                                 intersection1_x - platform_center_x);
-  float intersection2_angle_from_platform = atan2(intersection2_y - platform_center_y, 
-                                                 intersection2_x - platform_center_x);
-  
-  // Calculate platform angles for both solutions
-  float platform_angle1 = intersection1_angle_from_platform - original_angle;
-  float platform_angle2 = intersection2_angle_from_platform - original_angle;
-  
-  // Normalize platform angles to [-π, π]
-  while (platform_angle1 > PI) platform_angle1 -= 2*PI;
-  while (platform_angle1 < -PI) platform_angle1 += 2*PI;
-  while (platform_angle2 > PI) platform_angle2 -= 2*PI;
-  while (platform_angle2 < -PI) platform_angle2 += 2*PI;
-  
+
+  // Normalize platform angles to [-pi, pi]
+  solution.platform[0] = PolarKinematics::wrapHalfTurn(solution.platform[0]);
+  solution.platform[1] = PolarKinematics::wrapHalfTurn(solution.platform[1]);
+
   // Choose the solution with the minimum movement from current position
-  float theta1, theta2;
-  float movement1, movement2;
-  
-  if (first_move) {
-    // For first move, prefer the solution with platform angle closer to 0
-    movement1 = abs(platform_angle1);
-    movement2 = abs(platform_angle2);
-    first_move = false;
-  } else {
-    // Calculate total angular distance for both solutions
-    movement1 = abs(lever_angle1 - current_polar_angle) + abs(platform_angle1 - current_platform_angle);
-    movement2 = abs(lever_angle2 - current_polar_angle) + abs(platform_angle2 - current_platform_angle);
-  }
-  
-  // Choose the solution with less movement
-  if (movement1 <= movement2) {
-    theta1 = lever_angle1;
-    theta2 = platform_angle1;
-    DEBUG_SERIAL.println("Using first intersection (less movement)");
-    DEBUG_SERIAL.print("Movement cost: ");
-    DEBUG_SERIAL.println(movement1);
-    
-    DEBUG_SERIAL.print("World coordinates: (");
-    DEBUG_SERIAL.print(intersection1_x);
-    DEBUG_SERIAL.print(", ");
-    DEBUG_SERIAL.print(intersection1_y);
-    DEBUG_SERIAL.println(")");
-  } else {
-    theta1 = lever_angle2;
-    theta2 = platform_angle2;
-    DEBUG_SERIAL.println("Using second intersection (less movement)");
-    DEBUG_SERIAL.print("Movement cost: ");
-    DEBUG_SERIAL.println(movement2);
-    
-    DEBUG_SERIAL.print("World coordinates: (");
-    DEBUG_SERIAL.print(intersection2_x);
-    DEBUG_SERIAL.print(", ");
-    DEBUG_SERIAL.print(intersection2_y);
-    DEBUG_SERIAL.println(")");
-  }
-  
+  uint8_t pick = PolarKinematics::chooseSolution(solution, current_polar_angle, current_platform_angle, first_move);
+  first_move = false;
+  DEBUG_SERIAL.println(pick == 0 ? "Using first intersection (less movement)"
+                                 : "Using second intersection (less movement)");
+
   // Store current positions for next movement
-  current_polar_angle = theta1;
-  current_platform_angle = theta2;
-  
+  current_polar_angle = solution.lever[pick];
+  current_platform_angle = solution.platform[pick];
+
   // Print angles
   DEBUG_SERIAL.print("Platform angle (theta2) (deg): ");
-  DEBUG_SERIAL.println(degrees(theta2));
+  DEBUG_SERIAL.println(PolarKinematics::toDegrees(current_platform_angle));
   DEBUG_SERIAL.print("Lever angle (theta1) (deg): ");
-  DEBUG_SERIAL.println(degrees(theta1));
-  
-  // Convert to motor positions
-  float deg1 = fmod(degrees(theta1), 360.0f);
-  if (deg1 < 0) deg1 += 360.0f;
-  deg1 = deg1 + (POLAR_ARM_HOME/4096.0f*360.0f);
-  
-  float deg2 = fmod(degrees(theta2), 360.0f);
-  if (deg2 < 0) deg2 += 360.0f;
-  deg2 = deg2 + (PLATFORM_HOME/4096.0f*360.0f);
-  
+  DEBUG_SERIAL.println(PolarKinematics::toDegrees(current_polar_angle));
+
+  // Convert to motor positions - one turn of the binary angle, offset by home
+  uint16_t raw1 = (PolarKinematics::toTicks((uint16_t)current_polar_angle) + POLAR_ARM_HOME_TICKS) & 0x0FFF;
+  uint16_t raw2 = (PolarKinematics::toTicks((uint16_t)current_platform_angle) + PLATFORM_HOME_TICKS) & 0x0FFF;
+
   // Set motor positions
-  dxl.setGoalPosition(DXL_POLAR_ARM, degToRaw(deg1));
-  dxl.setGoalPosition(DXL_PLATFORM, degToRaw(deg2));
+  dxl.setGoalPosition(DXL_POLAR_ARM, raw1);
+  dxl.setGoalPosition(DXL_PLATFORM, raw2);
   
   waitForMotors();
   return true;
@@ -14,6 +14,7 @@
 #include <Wire.h>
 #include <Servo.h>
 #include "Config.h"
+#include <PolarKinematics.h>
 
 /**
  * @class HardwareControl
@@ -36,15 +37,10 @@ class HardwareControl {
     Servo servo2;  ///< Second gripper servo
     
     // Position tracking variables
-    float current_polar_angle;    ///< Current polar arm angle (radians)
-    float current_platform_angle; ///< Current platform angle (radians)
+    PolarKinematics::angle_t current_polar_angle;    ///< Current polar arm angle (binary angle)
+    PolarKinematics::angle_t current_platform_angle; ///< Current platform angle (binary angle)
     bool is_initialized;          ///< Hardware initialization status
     bool first_move;              ///< Flag for first movement optimization
-    
-    // Platform geometry parameters
-    float platform_center_x;  ///< Platform center X coordinate (mm)
-    float platform_center_y;  ///< Platform center Y coordinate (mm)
-    float platform_radius;    ///< Platform radius (mm)
 
     static const uint8_t EXTRUDER_I2C_ADDR = 0x08;  ///< I2C address of extruder controller
     
@@ -0,0 +1,381 @@
+/**
+ * @file DxlScheduler.cpp
+ * @brief Implementation of the Dynamixel bus transaction scheduler
+ */
+
+#include "DxlScheduler.h"
+
+// Protocol 2.0 instructions used by the queue
+static const uint8_t INST_SYNC_READ = 0x82;
+static const uint8_t INST_SYNC_WRITE = 0x83;
+static const uint8_t BROADCAST_ID = 0xFE;
+
+DxlScheduler::DxlScheduler(DxlTransport& transport)
+  : transport(transport) {
+  for (uint8_t i = 0; i < BUS_QUEUE_SIZE; i++) {
+    queue[i].state = SLOT_FREE;
+  }
+  active = -1;
+  baud = DXL_BAUD_RATE;
+  reserved_us = 0;
+  reserved = false;
+  observer = nullptr;
+  observer_ctx = nullptr;
+  resetStats();
+}
+
+/**
+ * @brief Bus rate used to estimate transaction times
+ */
+void DxlScheduler::setBaudRate(uint32_t baud) {
+  this->baud = baud;
+}
+
+/**
+ * @brief Hook called after every transaction (bus statistics)
+ */
+void DxlScheduler::setObserver(Observer observer, void* ctx) {
+  this->observer = observer;
+  observer_ctx = ctx;
+}
+
+// ============================================================================
+// SUBMISSION
+// ============================================================================
+
+/**
+ * @brief Claim a free slot
+ */
+int8_t DxlScheduler::allocate(BusClass bus_class, uint32_t deadline_us) {
+  for (uint8_t i = 0; i < BUS_QUEUE_SIZE; i++) {
+    if (queue[i].state == SLOT_FREE) {
+      Request& request = queue[i];
+      request.bus_class = bus_class;
+      request.detached = false;
+      request.deferred = false;
+      request.ok = false;
+      request.queued_us = micros();
+      request.deadline_us = deadline_us;
+      request.callback = nullptr;
+      request.ctx = nullptr;
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief Queue a Sync Read
+ * @param callback Called with the transport while the status packets are still in its buffer
+ * @param detached true if nobody will wait() on the handle
+ * @return Handle, or -1 if the queue is full
+ */
+int8_t DxlScheduler::submitSyncRead(BusClass bus_class, uint16_t addr, uint16_t len, const uint8_t* ids, uint8_t count,
+                                    uint32_t deadline_us, Callback callback, void* ctx, bool detached) {
+  if (count == 0 || count > DXL_MOTOR_COUNT) {
+    return -1;
+  }
+  int8_t handle = allocate(bus_class, deadline_us);
+  if (handle < 0) {
+    return -1;
+  }
+
+  Request& request = queue[handle];
+  request.instruction = INST_SYNC_READ;
+  request.expected_status = count;
+  request.params[0] = addr & 0xFF;
+  request.params[1] = addr >> 8;
+  request.params[2] = len & 0xFF;
+  request.params[3] = len >> 8;
+  memcpy(&request.params[4], ids, count);
+  request.param_len = 4 + count;
+  request.rx_estimate = count * (11 + len);
+  request.callback = callback;
+  request.ctx = ctx;
+  request.detached = detached;
+  request.state = SLOT_QUEUED;
+  service();
+  return handle;
+}
+
+/**
+ * @brief Queue a Sync Write of one register on several motors
+ * @return Handle, or -1 if the queue is full
+ */
+int8_t DxlScheduler::submitSyncWrite(BusClass bus_class, uint16_t addr, uint8_t len, const uint8_t* ids,
+                                     const int32_t* values, uint8_t count, uint32_t deadline_us) {
+  if (count == 0 || count > DXL_MOTOR_COUNT || len > sizeof(int32_t)) {
+    return -1;
+  }
+  int8_t handle = allocate(bus_class, deadline_us);
+  if (handle < 0) {
+    return -1;
+  }
+
+  Request& request = queue[handle];
+  request.instruction = INST_SYNC_WRITE;
+  request.expected_status = 0;
+  request.params[0] = addr & 0xFF;
+  request.params[1] = addr >> 8;
+  request.params[2] = len;
+  request.params[3] = 0;
+
+  // Per motor: ID, then the low 'len' bytes of the value (little-endian)
+  uint16_t pos = 4;
+  for (uint8_t i = 0; i < count; i++) {
+    request.params[pos++] = ids[i];
+    memcpy(&request.params[pos], &values[i], len);
+    pos += len;
+  }
+  request.param_len = pos;
+  request.rx_estimate = 0;
+
+  // A goal is about to go out - any reservation made for it is used up
+  if (bus_class == BUS_CLASS_GOAL) {
+    reserved = false;
+  }
+  request.state = SLOT_QUEUED;
+  service();
+  return handle;
+}
+
+/**
+ * @brief Queue a Sync Write of a run of consecutive registers on several motors
+ * @param data count * len bytes, one block per ID in control-table order
+ * @return Handle, or -1 if the queue is full or the packet would not fit
+ */
+int8_t DxlScheduler::submitSyncWriteBlock(BusClass bus_class, uint16_t addr, uint8_t len, const uint8_t* ids,
+                                          const uint8_t* data, uint8_t count, uint32_t deadline_us) {
+  if (count == 0 || count > DXL_MOTOR_COUNT ||
+      4 + count * (1 + len) > (int)sizeof(queue[0].params)) {
+    return -1;
+  }
+  int8_t handle = allocate(bus_class, deadline_us);
+  if (handle < 0) {
+    return -1;
+  }
+
+  Request& request = queue[handle];
+  request.instruction = INST_SYNC_WRITE;
+  request.expected_status = 0;
+  request.params[0] = addr & 0xFF;
+  request.params[1] = addr >> 8;
+  request.params[2] = len;
+  request.params[3] = 0;
+
+  uint16_t pos = 4;
+  for (uint8_t i = 0; i < count; i++) {
+    request.params[pos++] = ids[i];
+    memcpy(&request.params[pos], &data[i * len], len);
+    pos += len;
+  }
+  request.param_len = pos;
+  request.rx_estimate = 0;
+
+  if (bus_class == BUS_CLASS_GOAL) {
+    reserved = false;
+  }
+  request.state = SLOT_QUEUED;
+  service();
+  return handle;
+}
+
+// ============================================================================
+// SCHEDULING
+// ============================================================================
+
+/**
+ * @brief Class used for ordering - a request that has waited too long moves up one
+ */
+uint8_t DxlScheduler::effectiveClass(const Request& request, uint32_t now_us) const {
+  if (request.bus_class > BUS_CLASS_GOAL && (now_us - request.queued_us) >= BUS_AGING_US) {
+    return request.bus_class - 1;
+  }
+  return request.bus_class;
+}
+
+/**
+ * @brief Wire time of a request plus the motors' return delay
+ */
+uint32_t DxlScheduler::estimateUs(const Request& request) const {
+  uint32_t bits = (uint32_t)(10 + request.param_len + request.rx_estimate) * 10;
+  return (uint32_t)((uint64_t)bits * 1000000UL / baud) +
+         request.expected_status * (DXL_RETURN_DELAY_TIME * 2 + BUS_TURNAROUND_US);
+}
+
+/**
+ * @brief Status timeout for a request, measured from the end of its instruction
+ *
+ * The replies' own wire time and return delays, plus DXL_TRANSPORT_TIMEOUT_US
+ * of slack - a full telemetry Sync Read at 57600 takes far longer than the
+ * slack alone.
+ */
+uint32_t DxlScheduler::timeoutUs(const Request& request) const {
+  uint32_t bits = (uint32_t)request.rx_estimate * 10;
+  return (uint32_t)((uint64_t)bits * 1000000UL / baud) +
+         request.expected_status * (DXL_RETURN_DELAY_TIME * 2 + BUS_TURNAROUND_US) + DXL_TRANSPORT_TIMEOUT_US;
+}
+
+/**
+ * @brief Most urgent queued request: highest class, then earliest deadline
+ */
+int8_t DxlScheduler::pickNext(uint32_t now_us) {
+  int8_t best = -1;
+  for (uint8_t i = 0; i < BUS_QUEUE_SIZE; i++) {
+    if (queue[i].state != SLOT_QUEUED) {
+      continue;
+    }
+    if (best < 0) {
+      best = i;
+      continue;
+    }
+    uint8_t cls = effectiveClass(queue[i], now_us);
+    uint8_t best_cls = effectiveClass(queue[best], now_us);
+    if (cls < best_cls ||
+        (cls == best_cls && (int32_t)(queue[i].deadline_us - queue[best].deadline_us) < 0)) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Advance the bus without blocking
+ *
+ * Finishes the running transaction if the transport is done with it, then
+ * starts the most urgent queued one. Telemetry is only started if it will be
+ * off the bus before the reserved goal slot.
+ */
+void DxlScheduler::service() {
+  if (active >= 0) {
+    if (transport.poll() != DxlTransport::DONE && transport.busy()) {
+      return;
+    }
+    finish();
+    if (active >= 0) {
+      return;  // A callback already queued and started the next transaction
+    }
+  }
+
+  uint32_t now_us = micros();
+  if (reserved && (int32_t)(now_us - reserved_us) >= 0) {
+    reserved = false;
+  }
+
+  int8_t next = pickNext(now_us);
+  if (next < 0) {
+    return;
+  }
+
+  Request& request = queue[next];
+  if (reserved && request.bus_class == BUS_CLASS_TELEMETRY &&
+      (int32_t)(reserved_us - now_us) < (int32_t)estimateUs(request)) {
+    if (!request.deferred) {
+      stats[request.bus_class].deferred++;
+      request.deferred = true;
+    }
+    return;
+  }
+
+  uint32_t waited_us = now_us - request.queued_us;
+  stats[request.bus_class].wait_us += waited_us;
+  stats[request.bus_class].max_wait_us = max(stats[request.bus_class].max_wait_us, waited_us);
+
+  request.state = SLOT_ACTIVE;
+  active = next;
+  if (!transport.start(BROADCAST_ID, request.instruction, request.params, request.param_len,
+                       request.expected_status, timeoutUs(request))) {
+    finish();
+    return;
+  }
+
+  // Writes without status packets may already be complete
+  if (!transport.busy()) {
+    finish();
+  }
+}
+
+/**
+ * @brief Account and hand back the transaction that just ended
+ */
+void DxlScheduler::finish() {
+  Request& request = queue[active];
+  BusClassStats& cls = stats[request.bus_class];
+  bool ok = (transport.getState() == DxlTransport::DONE);
+  uint32_t now_us = micros();
+
+  cls.transactions++;
+  cls.bytes += transport.getTxBytes() + transport.getRxBytes();
+  cls.busy_us += now_us - transport.getStartMicros();
+  if (!ok) {
+    cls.failures++;
+  }
+  if ((int32_t)(now_us - request.deadline_us) > 0) {
+    cls.late++;
+  }
+
+  active = -1;
+  if (observer != nullptr) {
+    observer(observer_ctx, request.instruction, transport);
+  }
+  if (request.callback != nullptr) {
+    request.callback(request.ctx, transport, ok);
+  }
+  request.ok = ok;
+  request.state = request.detached ? SLOT_FREE : SLOT_DONE;
+}
+
+/**
+ * @brief Block until a request has run, then release its slot
+ * @return true if the transaction completed without error
+ */
+bool DxlScheduler::wait(int8_t handle) {
+  if (handle < 0 || handle >= BUS_QUEUE_SIZE || queue[handle].state == SLOT_FREE) {
+    return false;
+  }
+  while (queue[handle].state != SLOT_DONE) {
+    service();
+  }
+  queue[handle].state = SLOT_FREE;
+  return queue[handle].ok;
+}
+
+/**
+ * @brief Finish the running transaction so the port can be used directly
+ *
+ * Queued requests stay queued.
+ */
+void DxlScheduler::idle() {
+  while (active >= 0) {
+    transport.complete();
+    finish();
+  }
+}
+
+/**
+ * @brief Keep the bus free for a time-critical transaction at at_us
+ */
+void DxlScheduler::reserve(uint32_t at_us) {
+  reserved_us = at_us;
+  reserved = true;
+}
+
+/**
+ * @brief true if a request of this class is queued or running
+ */
+bool DxlScheduler::pending(BusClass bus_class) const {
+  for (uint8_t i = 0; i < BUS_QUEUE_SIZE; i++) {
+    if ((queue[i].state == SLOT_QUEUED || queue[i].state == SLOT_ACTIVE) && queue[i].bus_class == bus_class) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const BusClassStats& DxlScheduler::getStats(BusClass bus_class) const {
+  return stats[bus_class];
+}
+
+void DxlScheduler::resetStats() {
+  memset(stats, 0, sizeof(stats));
+}
@@ -0,0 +1,109 @@
+/**
+ * @file DxlScheduler.h
+ * @brief Priority queue for Dynamixel bus transactions
+ *
+ * Sits in front of DxlTransport. Requests are queued with a priority class
+ * and a deadline; service() starts the most urgent one whenever the bus is
+ * free. Lower classes are only admitted if they fit before the next reserved
+ * goal slot, so a background read never delays a goal write.
+ */
+
+#ifndef DXL_SCHEDULER_H
+#define DXL_SCHEDULER_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "DxlTransport.h"
+
+/**
+ * @brief Priority classes, most urgent first
+ */
+enum BusClass {
+  BUS_CLASS_GOAL,       // Goal and control-table writes
+  BUS_CLASS_INTERLOCK,  // Reads something is waiting on (moving poll, lift interlock)
+  BUS_CLASS_TELEMETRY,  // Background monitoring
+  BUS_CLASS_COUNT
+};
+
+/**
+ * @brief Per-class bandwidth and latency accounting
+ */
+struct BusClassStats {
+  uint32_t transactions;   // Transactions completed
+  uint32_t failures;       // Transactions that timed out or were corrupt
+  uint32_t bytes;          // Instruction + status bytes
+  uint32_t busy_us;        // Bus time used
+  uint32_t wait_us;        // Total time spent queued
+  uint32_t max_wait_us;    // Longest time spent queued
+  uint32_t deferred;       // Times held back to keep a goal slot free
+  uint32_t late;           // Completed after their deadline
+};
+
+class DxlScheduler {
+  public:
+    typedef void (*Callback)(void* ctx, const DxlTransport& transport, bool ok);
+    typedef void (*Observer)(void* ctx, uint8_t instruction, const DxlTransport& transport);
+
+    explicit DxlScheduler(DxlTransport& transport);
+
+    void setBaudRate(uint32_t baud);
+    void setObserver(Observer observer, void* ctx);
+
+    // Queue a transaction; returns a handle, or -1 if the queue is full
+    int8_t submitSyncRead(BusClass bus_class, uint16_t addr, uint16_t len, const uint8_t* ids, uint8_t count,
+                          uint32_t deadline_us, Callback callback = nullptr, void* ctx = nullptr,
+                          bool detached = false);
+    int8_t submitSyncWrite(BusClass bus_class, uint16_t addr, uint8_t len, const uint8_t* ids,
+                           const int32_t* values, uint8_t count, uint32_t deadline_us);
+    int8_t submitSyncWriteBlock(BusClass bus_class, uint16_t addr, uint8_t len, const uint8_t* ids,
+                                const uint8_t* data, uint8_t count, uint32_t deadline_us);
+
+    void service();
+    bool wait(int8_t handle);
+    void idle();
+    void reserve(uint32_t at_us);
+
+    bool pending(BusClass bus_class) const;
+    const BusClassStats& getStats(BusClass bus_class) const;
+    void resetStats();
+
+  private:
+    enum SlotState { SLOT_FREE, SLOT_QUEUED, SLOT_ACTIVE, SLOT_DONE };
+
+    struct Request {
+      uint8_t state;
+      uint8_t bus_class;
+      bool detached;             // Free the slot on completion - nobody calls wait()
+      bool deferred;             // Already counted as held back for a reservation
+      bool ok;
+      uint8_t instruction;
+      uint8_t expected_status;
+      uint16_t param_len;
+      uint16_t rx_estimate;      // Status bytes expected back
+      uint8_t params[4 + DXL_MOTOR_COUNT * 5];
+      uint32_t queued_us;
+      uint32_t deadline_us;
+      Callback callback;
+      void* ctx;
+    };
+
+    DxlTransport& transport;
+    Request queue[BUS_QUEUE_SIZE];
+    int8_t active;               // Slot on the transport, -1 if none
+    uint32_t baud;
+    uint32_t reserved_us;        // Next goal slot to keep free
+    bool reserved;
+
+    Observer observer;
+    void* observer_ctx;
+    BusClassStats stats[BUS_CLASS_COUNT];
+
+    int8_t allocate(BusClass bus_class, uint32_t deadline_us);
+    int8_t pickNext(uint32_t now_us);
+    uint8_t effectiveClass(const Request& request, uint32_t now_us) const;
+    uint32_t estimateUs(const Request& request) const;
+    uint32_t timeoutUs(const Request& request) const;
+    void finish();
+};
+
+#endif // DXL_SCHEDULER_H
@@ -0,0 +1,406 @@
+/**
+ * @file DxlTransport.cpp
+ * @brief Implementation of the non-blocking Dynamixel Protocol 2.0 transport
+ *
+ * The UART itself is interrupt driven by the core (TX and RX ring buffers
+ * filled/emptied from the SERCOM ISR); this class only moves bytes between
+ * those rings and its own packet buffers from poll(), so the CPU is free
+ * between calls.
+ */
+
+#include "DxlTransport.h"
+
+// Protocol 2.0 constants
+static const uint8_t INST_SYNC_READ = 0x82;
+static const uint8_t INST_STATUS = 0x55;
+static const uint8_t BROADCAST_ID = 0xFE;
+static const uint16_t HEADER_LEN = 7;   // FF FF FD 00 ID LEN_L LEN_H
+static const uint16_t STATUS_MIN_LEN = 4;  // Instruction, error, CRC
+
+// CRC-16 (polynomial 0x8005) as used by Protocol 2.0
+static const uint16_t CRC_TABLE[256] = {
+  0x0000, 0x8005, 0x800F, 0x000A, 0x801B, 0x001E, 0x0014, 0x8011,
+  0x8033, 0x0036, 0x003C, 0x8039, 0x0028, 0x802D, 0x8027, 0x0022,
+  0x8063, 0x0066, 0x006C, 0x8069, 0x0078, 0x807D, 0x8077, 0x0072,
+  0x0050, 0x8055, 0x805F, 0x005A, 0x804B, 0x004E, 0x0044, 0x8041,
+  0x80C3, 0x00C6, 0x00CC, 0x80C9, 0x00D8, 0x80DD, 0x80D7, 0x00D2,
+  0x00F0, 0x80F5, 0x80FF, 0x00FA, 0x80EB, 0x00EE, 0x00E4, 0x80E1,
+  0x00A0, 0x80A5, 0x80AF, 0x00AA, 0x80BB, 0x00BE, 0x00B4, 0x80B1,
+  0x8093, 0x0096, 0x009C, 0x8099, 0x0088, 0x808D, 0x8087, 0x0082,
+  0x8183, 0x0186, 0x018C, 0x8189, 0x0198, 0x819D, 0x8197, 0x0192,
+  0x01B0, 0x81B5, 0x81BF, 0x01BA, 0x81AB, 0x01AE, 0x01A4, 0x81A1,
+  0x01E0, 0x81E5, 0x81EF, 0x01EA, 0x81FB, 0x01FE, 0x01F4, 0x81F1,
+  0x81D3, 0x01D6, 0x01DC, 0x81D9, 0x01C8, 0x81CD, 0x81C7, 0x01C2,
+  0x0140, 0x8145, 0x814F, 0x014A, 0x815B, 0x015E, 0x0154, 0x8151,
+  0x8173, 0x0176, 0x017C, 0x8179, 0x0168, 0x816D, 0x8167, 0x0162,
+  0x8123, 0x0126, 0x012C, 0x8129, 0x0138, 0x813D, 0x8137, 0x0132,
+  0x0110, 0x8115, 0x811F, 0x011A, 0x810B, 0x010E, 0x0104, 0x8101,
+  0x8303, 0x0306, 0x030C, 0x8309, 0x0318, 0x831D, 0x8317, 0x0312,
+  0x0330, 0x8335, 0x833F, 0x033A, 0x832B, 0x032E, 0x0324, 0x8321,
+  0x0360, 0x8365, 0x836F, 0x036A, 0x837B, 0x037E, 0x0374, 0x8371,
+  0x8353, 0x0356, 0x035C, 0x8359, 0x0348, 0x834D, 0x8347, 0x0342,
+  0x03C0, 0x83C5, 0x83CF, 0x03CA, 0x83DB, 0x03DE, 0x03D4, 0x83D1,
+  0x83F3, 0x03F6, 0x03FC, 0x83F9, 0x03E8, 0x83ED, 0x83E7, 0x03E2,
+  0x83A3, 0x03A6, 0x03AC, 0x83A9, 0x03B8, 0x83BD, 0x83B7, 0x03B2,
+  0x0390, 0x8395, 0x839F, 0x039A, 0x838B, 0x038E, 0x0384, 0x8381,
+  0x0280, 0x8285, 0x828F, 0x028A, 0x829B, 0x029E, 0x0294, 0x8291,
+  0x82B3, 0x02B6, 0x02BC, 0x82B9, 0x02A8, 0x82AD, 0x82A7, 0x02A2,
+  0x82E3, 0x02E6, 0x02EC, 0x82E9, 0x02F8, 0x82FD, 0x82F7, 0x02F2,
+  0x02D0, 0x82D5, 0x82DF, 0x02DA, 0x82CB, 0x02CE, 0x02C4, 0x82C1,
+  0x8243, 0x0246, 0x024C, 0x8249, 0x0258, 0x825D, 0x8257, 0x0252,
+  0x0270, 0x8275, 0x827F, 0x027A, 0x826B, 0x026E, 0x0264, 0x8261,
+  0x0220, 0x8225, 0x822F, 0x022A, 0x823B, 0x023E, 0x0234, 0x8231,
+  0x8213, 0x0216, 0x021C, 0x8219, 0x0208, 0x820D, 0x8207, 0x0202
+};
+
+DxlTransport::DxlTransport(HardwareSerial& port, int dir_pin)
+  : port(port), dir_pin(dir_pin) {
+  state = IDLE;
+  last_error = DXL_LIB_OK;
+  start_us = 0;
+  rx_start_us = 0;
+  timeout_us = DXL_TRANSPORT_TIMEOUT_US;
+  tx_len = 0;
+  tx_pos = 0;
+  rx_len = 0;
+  rx_parsed = 0;
+  status_count = 0;
+  expected_status = 0;
+}
+
+/**
+ * @brief Configure the direction pin; the port itself is opened by Dynamixel2Arduino
+ */
+void DxlTransport::begin() {
+  if (dir_pin >= 0) {
+    pinMode(dir_pin, OUTPUT);
+    digitalWrite(dir_pin, LOW);
+  }
+}
+
+// ============================================================================
+// TRANSACTIONS
+// ============================================================================
+
+/**
+ * @brief Queue an instruction packet and start the transaction
+ * @param id Target ID (0xFE for broadcast)
+ * @param instruction Protocol 2.0 instruction byte
+ * @param params Instruction parameters (unstuffed)
+ * @param expected_status Status packets to wait for (0 = fire-and-forget)
+ * @param timeout_us Time allowed for all status packets after the instruction is sent;
+ *        must cover their wire time at the current baud rate
+ * @return false if a transaction is still running or the packet does not fit
+ */
+bool DxlTransport::start(uint8_t id, uint8_t instruction, const uint8_t* params, uint16_t param_len,
+                         uint8_t expected_status, uint32_t timeout_us) {
+  if (busy() || expected_status > DXL_MOTOR_COUNT) {
+    return false;
+  }
+  if (!buildPacket(id, instruction, params, param_len)) {
+    last_error = DXL_LIB_ERROR_BUFFER_OVERFLOW;
+    state = FAILED;
+    return false;
+  }
+
+  // Anything still in the RX ring belongs to an earlier exchange
+  while (port.available() > 0) {
+    port.read();
+  }
+
+  this->expected_status = expected_status;
+  this->timeout_us = timeout_us;
+  tx_pos = 0;
+  rx_len = 0;
+  rx_parsed = 0;
+  status_count = 0;
+  last_error = DXL_LIB_OK;
+  start_us = micros();
+
+  if (dir_pin >= 0) {
+    digitalWrite(dir_pin, HIGH);
+  }
+  state = SENDING;
+  pumpTx();
+  return true;
+}
+
+/**
+ * @brief Start a Sync Read of the same address range from several motors
+ */
+bool DxlTransport::startSyncRead(uint16_t addr, uint16_t len, const uint8_t* ids, uint8_t count,
+                                 uint32_t timeout_us) {
+  uint8_t params[4 + DXL_MOTOR_COUNT];
+  if (count == 0 || count > DXL_MOTOR_COUNT) {
+    return false;
+  }
+
+  params[0] = addr & 0xFF;
+  params[1] = addr >> 8;
+  params[2] = len & 0xFF;
+  params[3] = len >> 8;
+  memcpy(&params[4], ids, count);
+  return start(BROADCAST_ID, INST_SYNC_READ, params, 4 + count, count, timeout_us);
+}
+
+/**
+ * @brief Advance the running transaction without blocking
+ * @return State after this step
+ */
+DxlTransport::State DxlTransport::poll() {
+  switch (state) {
+    case SENDING:
+      pumpTx();
+      break;
+
+    case DRAINING:
+      // Everything is already in the TX ring - at most a ring's worth of bytes to wait for
+      port.flush();
+      if (dir_pin >= 0) {
+        digitalWrite(dir_pin, LOW);
+      }
+      state = (expected_status == 0) ? DONE : RECEIVING;
+      rx_start_us = micros();
+      break;
+
+    case RECEIVING:
+      pumpRx();
+      if (state == RECEIVING && (micros() - rx_start_us) >= timeout_us) {
+        fail(DXL_LIB_ERROR_TIMEOUT);
+      }
+      break;
+
+    default:
+      break;
+  }
+  return state;
+}
+
+/**
+ * @brief Run the transaction to the end
+ * @return true if every expected status packet arrived intact
+ */
+bool DxlTransport::complete() {
+  while (busy()) {
+    poll();
+  }
+  return state == DONE;
+}
+
+/**
+ * @brief Blocking exchange for callers that want the result right away
+ */
+bool DxlTransport::transfer(uint8_t id, uint8_t instruction, const uint8_t* params, uint16_t param_len,
+                            uint8_t expected_status, uint32_t timeout_us) {
+  if (!start(id, instruction, params, param_len, expected_status, timeout_us)) {
+    return false;
+  }
+  return complete();
+}
+
+// ============================================================================
+// RESULT ACCESS
+// ============================================================================
+
+bool DxlTransport::busy() const {
+  return state == SENDING || state == DRAINING || state == RECEIVING;
+}
+
+DxlTransport::State DxlTransport::getState() const {
+  return state;
+}
+
+uint8_t DxlTransport::getStatusCount() const {
+  return status_count;
+}
+
+const DxlTransport::Status* DxlTransport::getStatus(uint8_t index) const {
+  return (index < status_count) ? &statuses[index] : nullptr;
+}
+
+const DxlTransport::Status* DxlTransport::findStatus(uint8_t id) const {
+  for (uint8_t i = 0; i < status_count; i++) {
+    if (statuses[i].id == id) {
+      return &statuses[i];
+    }
+  }
+  return nullptr;
+}
+
+uint8_t DxlTransport::lastError() const {
+  return last_error;
+}
+
+uint32_t DxlTransport::getStartMicros() const {
+  return start_us;
+}
+
+uint16_t DxlTransport::getTxBytes() const {
+  return tx_len;
+}
+
+uint16_t DxlTransport::getRxBytes() const {
+  return rx_len;
+}
+
+// ============================================================================
+// PACKET HANDLING
+// ============================================================================
+
+/**
+ * @brief Build a stuffed, CRC-terminated instruction packet in tx_buf
+ */
+bool DxlTransport::buildPacket(uint8_t id, uint8_t instruction, const uint8_t* params, uint16_t param_len) {
+  uint16_t pos = 0;
+  tx_buf[pos++] = 0xFF;
+  tx_buf[pos++] = 0xFF;
+  tx_buf[pos++] = 0xFD;
+  tx_buf[pos++] = 0x00;
+  tx_buf[pos++] = id;
+  pos += 2;  // Length, filled in once stuffing is known
+  tx_buf[pos++] = instruction;
+
+  for (uint16_t i = 0; i < param_len; i++) {
+    if (pos + 3 > DXL_PACKET_BUF_SIZE) {
+      return false;
+    }
+    tx_buf[pos++] = params[i];
+    // FF FF FD inside the payload would look like a header - append a stuffing FD
+    if (pos - 3 >= HEADER_LEN && tx_buf[pos - 3] == 0xFF && tx_buf[pos - 2] == 0xFF && tx_buf[pos - 1] == 0xFD) {
+      tx_buf[pos++] = 0xFD;
+    }
+  }
+  if (pos + 2 > DXL_PACKET_BUF_SIZE) {
+    return false;
+  }
+
+  uint16_t length = pos - HEADER_LEN + 2;
+  tx_buf[5] = length & 0xFF;
+  tx_buf[6] = length >> 8;
+
+  uint16_t crc = crc16(0, tx_buf, pos);
+  tx_buf[pos++] = crc & 0xFF;
+  tx_buf[pos++] = crc >> 8;
+  tx_len = pos;
+  return true;
+}
+
+void DxlTransport::fail(uint8_t error) {
+  last_error = error;
+  state = FAILED;
+}
+
+/**
+ * @brief Move as much of the instruction packet into the TX ring as fits
+ */
+void DxlTransport::pumpTx() {
+  while (tx_pos < tx_len) {
+    int room = port.availableForWrite();
+    if (room <= 0) {
+      return;
+    }
+    uint16_t n = min((uint16_t)room, (uint16_t)(tx_len - tx_pos));
+    port.write(tx_buf + tx_pos, n);
+    tx_pos += n;
+  }
+
+  // The bus must not be released before the last stop bit, and the status
+  // timeout only runs once the instruction is off the wire
+  state = DRAINING;
+}
+
+/**
+ * @brief Drain the RX ring into rx_buf and parse any complete status packets
+ */
+void DxlTransport::pumpRx() {
+  int available = port.available();
+  while (available-- > 0) {
+    if (rx_len >= DXL_TRANSPORT_RX_SIZE) {
+      fail(DXL_LIB_ERROR_BUFFER_OVERFLOW);
+      return;
+    }
+    rx_buf[rx_len++] = port.read();
+  }
+
+  while (state == RECEIVING && parseStatus()) {
+    if (status_count == expected_status) {
+      state = DONE;
+    }
+  }
+}
+
+/**
+ * @brief Parse the next status packet in rx_buf where it lies
+ * @return true if a packet was consumed, false if more bytes are needed
+ */
+bool DxlTransport::parseStatus() {
+  // Skip noise up to the next header
+  while (rx_len - rx_parsed >= 4) {
+    const uint8_t* p = &rx_buf[rx_parsed];
+    if (p[0] == 0xFF && p[1] == 0xFF && p[2] == 0xFD && p[3] == 0x00) {
+      break;
+    }
+    rx_parsed++;
+  }
+  if (rx_len - rx_parsed < HEADER_LEN) {
+    return false;
+  }
+
+  uint8_t* packet = &rx_buf[rx_parsed];
+  uint16_t length = packet[5] | (packet[6] << 8);
+  if (length < STATUS_MIN_LEN || rx_parsed + HEADER_LEN + length > DXL_TRANSPORT_RX_SIZE) {
+    fail(DXL_LIB_ERROR_WRONG_PACKET);
+    return false;
+  }
+  if (rx_len - rx_parsed < HEADER_LEN + length) {
+    return false;
+  }
+
+  uint16_t end = HEADER_LEN + length - 2;
+  uint16_t crc = packet[end] | (packet[end + 1] << 8);
+  if (crc16(0, packet, end) != crc) {
+    fail(DXL_LIB_ERROR_CRC);
+    return false;
+  }
+  if (packet[7] != INST_STATUS) {
+    fail(DXL_LIB_ERROR_WRONG_PACKET);
+    return false;
+  }
+
+  // Remove byte stuffing from the parameters in place
+  // (FF FF FD FD on the wire is FF FF FD in the data)
+  uint8_t h0 = 0, h1 = packet[7], h2 = packet[8];  // Last three bytes of the stuffed stream
+  uint16_t w = 9;
+  for (uint16_t r = 9; r < end; r++) {
+    uint8_t b = packet[r];
+    bool stuffing = (h0 == 0xFF && h1 == 0xFF && h2 == 0xFD && b == 0xFD);
+    h0 = h1;
+    h1 = h2;
+    h2 = b;
+    if (stuffing) {
+      h2 = 0;  // The stuffing byte cannot start another sequence
+      continue;
+    }
+    packet[w++] = b;
+  }
+
+  if (status_count < DXL_MOTOR_COUNT) {
+    Status& status = statuses[status_count++];
+    status.id = packet[4];
+    status.error = packet[8];
+    status.data = &packet[9];
+    status.length = w - 9;
+  }
+  rx_parsed += HEADER_LEN + length;
+  return true;
+}
+
+/**
+ * @brief Protocol 2.0 CRC-16 over a byte range
+ */
+uint16_t DxlTransport::crc16(uint16_t crc, const uint8_t* data, uint16_t len) {
+  for (uint16_t i = 0; i < len; i++) {
+    crc = (crc << 8) ^ CRC_TABLE[((crc >> 8) ^ data[i]) & 0xFF];
+  }
+  return crc;
+}
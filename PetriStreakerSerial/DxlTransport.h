@@ -0,0 +1,102 @@
+/**
+ * @file DxlTransport.h
+ * @brief Non-blocking Dynamixel Protocol 2.0 transport
+ *
+ * Runs one instruction/status exchange on the Dynamixel UART without
+ * blocking: start() queues the instruction packet, poll() feeds the TX
+ * ring and drains the interrupt-driven RX ring, and complete() waits for
+ * the result when the caller needs it right away.
+ *
+ * Status packets are parsed in place in the receive buffer - Status::data
+ * points straight at the (de-stuffed) parameters, nothing is copied.
+ */
+
+#ifndef DXL_TRANSPORT_H
+#define DXL_TRANSPORT_H
+
+#include <Arduino.h>
+#include <Dynamixel2Arduino.h>
+#include "Config.h"
+
+class DxlTransport {
+  public:
+    enum State {
+      IDLE,       // No transaction
+      SENDING,    // Instruction bytes still being queued
+      DRAINING,   // Last bytes leaving the TX ring and shift register
+      RECEIVING,  // Waiting for status packets
+      DONE,       // All expected status packets parsed
+      FAILED      // Timeout or corrupt packet - see lastError()
+    };
+
+    /**
+     * @brief One parsed status packet
+     */
+    struct Status {
+      uint8_t id;           // Responding motor
+      uint8_t error;        // Status packet error field
+      const uint8_t* data;  // Parameters, inside the receive buffer
+      uint16_t length;      // Parameter bytes
+    };
+
+    DxlTransport(HardwareSerial& port, int dir_pin);
+
+    void begin();
+
+    // Transactions
+    bool start(uint8_t id, uint8_t instruction, const uint8_t* params, uint16_t param_len,
+               uint8_t expected_status, uint32_t timeout_us = DXL_TRANSPORT_TIMEOUT_US);
+    bool startSyncRead(uint16_t addr, uint16_t len, const uint8_t* ids, uint8_t count,
+                       uint32_t timeout_us = DXL_TRANSPORT_TIMEOUT_US);
+    State poll();
+    bool complete();
+
+    // Blocking wrapper - start() followed by complete()
+    bool transfer(uint8_t id, uint8_t instruction, const uint8_t* params, uint16_t param_len,
+                  uint8_t expected_status, uint32_t timeout_us = DXL_TRANSPORT_TIMEOUT_US);
+
+    // Result of the last transaction
+    bool busy() const;
+    State getState() const;
+    uint8_t getStatusCount() const;
+    const Status* getStatus(uint8_t index) const;
+    const Status* findStatus(uint8_t id) const;
+    uint8_t lastError() const;
+    uint32_t getStartMicros() const;
+    uint16_t getTxBytes() const;
+    uint16_t getRxBytes() const;
+
+  private:
+    HardwareSerial& port;
+    int dir_pin;
+
+    State state;
+    uint8_t last_error;          // DXLLibErrorCode of the last failure
+    uint32_t start_us;
+    uint32_t rx_start_us;        // micros() when the instruction finished sending
+    uint32_t timeout_us;
+
+    // Instruction packet, already stuffed and CRC'd
+    uint8_t tx_buf[DXL_PACKET_BUF_SIZE];
+    uint16_t tx_len;
+    uint16_t tx_pos;
+
+    // Raw status bytes; packets are de-stuffed where they lie
+    uint8_t rx_buf[DXL_TRANSPORT_RX_SIZE];
+    uint16_t rx_len;
+    uint16_t rx_parsed;
+
+    Status statuses[DXL_MOTOR_COUNT];
+    uint8_t status_count;
+    uint8_t expected_status;
+
+    bool buildPacket(uint8_t id, uint8_t instruction, const uint8_t* params, uint16_t param_len);
+    void fail(uint8_t error);
+    void pumpTx();
+    void pumpRx();
+    bool parseStatus();
+
+    static uint16_t crc16(uint16_t crc, const uint8_t* data, uint16_t len);
+};
+
+#endif // DXL_TRANSPORT_H
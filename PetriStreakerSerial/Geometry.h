@@ -0,0 +1,25 @@
+/**
+ * @file Geometry.h
+ * @brief Drawing geometry and the polar arm / platform homes
+ *
+ * Everything the inverse kinematics depends on, kept free of Arduino
+ * headers so the host trajectory tool (Nuk/StreakTrajectory) compiles
+ * against exactly the same numbers as the firmware. Included by Config.h.
+ */
+
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#define POLAR_ARM_LENGTH   98.995f  // Polar arm length [mm]
+#define PLATFORM_CENTER_X  70.0f   // Platform center relative to the arm pivot [mm]
+#define PLATFORM_CENTER_Y  70.0f
+#define PLATFORM_RADIUS    45.0f   // Points further out are pulled in to the dish edge [mm]
+#define POINT_MIN_RADIUS   1.0f    // Points closer to the center are skipped (singularity) [mm]
+#define CENTER_PASS_RADIUS 1.0f    // Segments passing closer go through the center (CenterPass.h) [mm]; 0 = off
+//#define POLAR_ARM_HOME    (178.51f/360.0f*4096.0f)  // DO NOT MODIFY USEFUL FOR CALCULATIONS - DO NOT GO THERE
+#define POLAR_ARM_HOME    (0.51f/360.0f*4096.0f)  // DO NOT MODIFY USEFUL FOR CALCULATIONS - DO NOT GO THERE
+#define POLAR_ARM_HOME_TICKS ((int32_t)(POLAR_ARM_HOME + 0.5f))
+#define PLATFORM_HOME     1238.0f  // Platform home position to not obstruct 
+#define PLATFORM_HOME_TICKS ((int32_t)(PLATFORM_HOME + 0.5f))
+
+#endif // GEOMETRY_H
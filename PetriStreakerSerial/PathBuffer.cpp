@@ -0,0 +1,204 @@
+/**
+ * @file PathBuffer.cpp
+ * @brief Implementation of the uploaded pattern ring buffer
+ */
+
+#include "PathBuffer.h"
+
+// Longest PATH DATA payload: PATH_DATA_MAX_POINTS Cartesian points of 4 bytes
+static const uint16_t MAX_DATA_BYTES = PATH_DATA_MAX_POINTS * 4;
+
+// Joint record that does not fit in two int8 steps: escape byte, then two int16
+static const uint8_t JOINT_ESCAPE = 0x80;
+
+PathBuffer::PathBuffer() {
+  generation = 0;
+  clear();
+}
+
+/**
+ * @brief Drop whatever is stored and open a new pattern
+ */
+void PathBuffer::begin(uint8_t id, Kind kind) {
+  clear();
+  this->id = id;
+  this->kind = kind;
+  generation++;
+  open = true;
+}
+
+/**
+ * @brief Mark the pattern complete - the executor stops once the buffer empties
+ */
+void PathBuffer::end() {
+  if (open) {
+    ended = true;
+  }
+}
+
+void PathBuffer::clear() {
+  head = 0;
+  count = 0;
+  id = 0;
+  kind = CARTESIAN;
+  open = false;
+  ended = false;
+  consumed = false;
+}
+
+int8_t PathBuffer::hexDigit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+/**
+ * @brief Store hex-encoded points at the tail
+ *
+ * The line is checked completely before anything is stored, so a rejected
+ * line leaves the buffer as it was and the host can resend it.
+ */
+PathBuffer::AppendResult PathBuffer::append(const char* hex, uint16_t length) {
+  if (!open || ended) {
+    return APPEND_CLOSED;
+  }
+  if (length == 0 || length % 2 != 0 || length / 2 > MAX_DATA_BYTES) {
+    return APPEND_INVALID;
+  }
+
+  uint8_t bytes[MAX_DATA_BYTES];
+  for (uint16_t i = 0; i < length / 2; i++) {
+    int8_t high = hexDigit(hex[2 * i]);
+    int8_t low = hexDigit(hex[2 * i + 1]);
+    if (high < 0 || low < 0) {
+      return APPEND_INVALID;
+    }
+    bytes[i] = (uint8_t)(high << 4 | low);
+  }
+
+  // Joint records can be 2 bytes, so a line holds up to twice as many of them
+  PathPoint decoded[MAX_DATA_BYTES / 2];
+  uint16_t n = (kind == JOINT) ? decodeJoint(bytes, length / 2, decoded)
+                               : decodeCartesian(bytes, length / 2, decoded);
+  if (n == 0) {
+    return APPEND_INVALID;
+  }
+  if (n > space()) {
+    return APPEND_OVERFLOW;
+  }
+
+  for (uint16_t i = 0; i < n; i++) {
+    points[(head + count) % PATH_BUFFER_POINTS] = decoded[i];
+    count++;
+  }
+  return APPEND_OK;
+}
+
+/**
+ * @brief Cartesian points: int16 x then int16 y, each little-endian
+ * @return Points decoded, 0 if the payload is malformed
+ */
+uint16_t PathBuffer::decodeCartesian(const uint8_t* bytes, uint16_t length, PathPoint* out) {
+  if (length % 4 != 0) {
+    return 0;
+  }
+  for (uint16_t i = 0; i < length / 4; i++) {
+    const uint8_t* p = &bytes[i * 4];
+    out[i].x = (int16_t)(p[0] | p[1] << 8);
+    out[i].y = (int16_t)(p[2] | p[3] << 8);
+  }
+  return length / 4;
+}
+
+/**
+ * @brief Joint steps: int8 polar, int8 platform - or, for larger steps,
+ * JOINT_ESCAPE followed by int16 polar and int16 platform (little-endian)
+ * @return Steps decoded, 0 if the payload is malformed
+ */
+uint16_t PathBuffer::decodeJoint(const uint8_t* bytes, uint16_t length, PathPoint* out) {
+  uint16_t n = 0;
+  uint16_t pos = 0;
+  while (pos < length) {
+    if (bytes[pos] == JOINT_ESCAPE) {
+      if (pos + 5 > length) {
+        return 0;
+      }
+      out[n].x = (int16_t)(bytes[pos + 1] | bytes[pos + 2] << 8);
+      out[n].y = (int16_t)(bytes[pos + 3] | bytes[pos + 4] << 8);
+      pos += 5;
+    } else {
+      if (pos + 2 > length) {
+        return 0;
+      }
+      out[n].x = (int8_t)bytes[pos];
+      out[n].y = (int8_t)bytes[pos + 1];
+      pos += 2;
+    }
+    n++;
+  }
+  return n;
+}
+
+/**
+ * @brief Take the oldest point out, freeing its slot
+ * @return false if the buffer is empty
+ */
+bool PathBuffer::pop(PathPoint& point) {
+  if (count == 0) {
+    return false;
+  }
+  point = points[head];
+  head = (head + 1) % PATH_BUFFER_POINTS;
+  count--;
+  consumed = true;
+  return true;
+}
+
+/**
+ * @brief Point 'index' from the oldest, without removing it (resident patterns)
+ */
+const PathPoint& PathBuffer::at(uint16_t index) const {
+  return points[(head + index) % PATH_BUFFER_POINTS];
+}
+
+uint8_t PathBuffer::getId() const {
+  return id;
+}
+
+uint16_t PathBuffer::getGeneration() const {
+  return generation;
+}
+
+PathBuffer::Kind PathBuffer::getKind() const {
+  return (Kind)kind;
+}
+
+uint16_t PathBuffer::size() const {
+  return count;
+}
+
+uint16_t PathBuffer::space() const {
+  return PATH_BUFFER_POINTS - count;
+}
+
+bool PathBuffer::isOpen() const {
+  return open;
+}
+
+bool PathBuffer::isEnded() const {
+  return ended;
+}
+
+/**
+ * @brief true if the whole pattern is in RAM and can be run again
+ */
+bool PathBuffer::isResident() const {
+  return ended && !consumed;
+}
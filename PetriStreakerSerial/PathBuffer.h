@@ -0,0 +1,80 @@
+/**
+ * @file PathBuffer.h
+ * @brief RAM ring buffer for patterns uploaded from the host
+ *
+ * Holds one uploaded pattern (PATH command), either as platform points -
+ * hex-encoded int16 pairs in 1/100 mm - or as a joint trajectory solved on
+ * the host - delta-encoded raw ticks, see decodeJoint(). The buffer is a
+ * ring, so a pattern longer than PATH_BUFFER_POINTS can be streamed in while
+ * it runs. A pattern that was ended before anything was taken out stays
+ * resident and can be run again.
+ */
+
+#ifndef PATH_BUFFER_H
+#define PATH_BUFFER_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+/**
+ * @brief One uploaded point
+ *
+ * Cartesian patterns: platform-relative position (1/100 mm).
+ * Joint trajectories: step from the previous point (raw ticks) - x is the
+ * polar arm, y the platform.
+ */
+struct PathPoint {
+  int16_t x;
+  int16_t y;
+};
+
+class PathBuffer {
+  public:
+    enum Kind {
+      CARTESIAN,  // Platform points, solved on the board
+      JOINT       // Joint steps, solved on the host
+    };
+
+    enum AppendResult {
+      APPEND_OK,
+      APPEND_INVALID,   // Not a whole number of points, or not hex
+      APPEND_OVERFLOW,  // More points than free slots - nothing stored
+      APPEND_CLOSED     // No pattern open, or it was already ended
+    };
+
+    PathBuffer();
+
+    void begin(uint8_t id, Kind kind = CARTESIAN);
+    void end();
+    void clear();
+    AppendResult append(const char* hex, uint16_t length);
+
+    bool pop(PathPoint& point);
+    const PathPoint& at(uint16_t index) const;
+
+    uint8_t getId() const;
+    uint16_t getGeneration() const;
+    Kind getKind() const;
+    uint16_t size() const;
+    uint16_t space() const;
+    bool isOpen() const;
+    bool isEnded() const;
+    bool isResident() const;
+
+  private:
+    PathPoint points[PATH_BUFFER_POINTS];
+    uint16_t head;   // Oldest point
+    uint16_t count;  // Points stored
+    uint8_t id;
+    uint16_t generation;  // Counts begin() calls - tells re-uploads of the same ID apart
+    uint8_t kind;
+    bool open;       // begin() called, not cleared
+    bool ended;      // End mark received - no more points follow
+    bool consumed;   // Points have been taken out with pop()
+
+    static int8_t hexDigit(char c);
+    static uint16_t decodeCartesian(const uint8_t* bytes, uint16_t length, PathPoint* out);
+    static uint16_t decodeJoint(const uint8_t* bytes, uint16_t length, PathPoint* out);
+};
+
+#endif // PATH_BUFFER_H
@@ -0,0 +1,393 @@
+/**
+ * @file PatternTables.h
+ * @brief Built-in streak patterns, solved to joint goals at compile time
+ *
+ * A fixed pattern is declared as a shape with its parameters. The compiler
+ * walks the shape, runs the inverse kinematics (PolarKinematics::Solver::
+ * solveConst), plans the branches over the whole pattern the same way the
+ * run-time path does (BranchPlanner.h, BRANCH_PLAN_MODE), adds the centre
+ * poses of segments that pass the platform centre (CenterPass.h), and emits
+ * a const array of raw goals that lives in flash. Running a pattern is then
+ * only streaming those goals - no per-point math on the board.
+ *
+ * To add a pattern: declare a shape in hardware.cpp and add a STREAK_PATTERN()
+ * entry for it.
+ */
+
+#ifndef PATTERN_TABLES_H
+#define PATTERN_TABLES_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include <PolarKinematics.h>
+#include <BranchPlanner.h>
+#include <CenterPass.h>
+
+/**
+ * @brief One point of a pattern, platform-relative (mm)
+ */
+struct PatternPoint {
+  double x;
+  double y;
+  bool stop;  // Settle here before continuing (corner)
+};
+
+// ============================================================================
+// SHAPES
+// ============================================================================
+// Same point sequences as drawLine(), drawCircle(), drawSpiral() and
+// drawFlower(), plus the quadrant and zigzag patterns.
+
+struct LineShape {
+  double x1, y1, x2, y2;
+  int points;
+
+  constexpr LineShape(double x1, double y1, double x2, double y2, int points)
+    : x1(x1), y1(y1), x2(x2), y2(y2), points(points) {}
+  constexpr int count() const { return points; }
+  constexpr PatternPoint at(int i) const {
+    return PatternPoint{x1 + (double)i / (points - 1) * (x2 - x1), y1 + (double)i / (points - 1) * (y2 - y1), false};
+  }
+};
+
+struct CircleShape {
+  double radius;
+  int points;
+
+  constexpr CircleShape(double radius, int points) : radius(radius), points(points) {}
+  constexpr int count() const { return points; }
+  constexpr PatternPoint at(int i) const {
+    return PatternPoint{radius * PolarKinematics::constCos(2.0 * PolarKinematics::CONST_PI * i / points),
+                        radius * PolarKinematics::constSin(2.0 * PolarKinematics::CONST_PI * i / points), false};
+  }
+};
+
+struct SpiralShape {
+  double max_radius, revolutions;
+  int points;
+
+  constexpr SpiralShape(double max_radius, double revolutions, int points)
+    : max_radius(max_radius), revolutions(revolutions), points(points) {}
+  constexpr int count() const { return points; }
+  constexpr PatternPoint at(int i) const {
+    return PatternPoint{t(i) * max_radius * PolarKinematics::constCos(angle(i)),
+                        t(i) * max_radius * PolarKinematics::constSin(angle(i)), false};
+  }
+  constexpr double t(int i) const { return (double)i / (points - 1); }
+  constexpr double angle(int i) const { return -t(i) * revolutions * 2.0 * PolarKinematics::CONST_PI; }
+};
+
+struct FlowerShape {
+  double radius, amplitude;
+  int petals, points;
+
+  constexpr FlowerShape(double radius, double amplitude, int petals, int points)
+    : radius(radius), amplitude(amplitude), petals(petals), points(points) {}
+  constexpr int count() const { return points; }
+  constexpr PatternPoint at(int i) const {
+    return PatternPoint{r(i) * PolarKinematics::constCos(angle(i)), r(i) * PolarKinematics::constSin(angle(i)), false};
+  }
+  constexpr double angle(int i) const { return 2.0 * PolarKinematics::CONST_PI * i / points; }
+  constexpr double r(int i) const { return radius + amplitude * PolarKinematics::constSin(petals * angle(i)); }
+};
+
+/**
+ * @brief Square of side 2 * half, drawn edge by edge, settling at each corner
+ */
+struct SquareShape {
+  double half;
+  int per_side;
+
+  constexpr SquareShape(double half, int per_side) : half(half), per_side(per_side) {}
+  constexpr int count() const { return 4 * per_side; }
+  constexpr PatternPoint at(int i) const {
+    return PatternPoint{
+      cornerX(i / per_side) + (double)(i % per_side) / (per_side - 1) * (cornerX(i / per_side + 1) - cornerX(i / per_side)),
+      cornerY(i / per_side) + (double)(i % per_side) / (per_side - 1) * (cornerY(i / per_side + 1) - cornerY(i / per_side)),
+      i % per_side == per_side - 1};
+  }
+  // Corners counter-clockwise from (-half, -half); corner 4 closes the square
+  constexpr double cornerX(int corner) const { return (corner == 1 || corner == 2) ? half : -half; }
+  constexpr double cornerY(int corner) const { return (corner == 2 || corner == 3) ? half : -half; }
+};
+
+/**
+ * @brief Start point, then strokes alternating between two Y values, stopping at each point
+ */
+struct ZigzagShape {
+  double x, y, y_first, y_second, step;
+  int strokes;
+
+  constexpr ZigzagShape(double x, double y, double y_first, double y_second, double step, int strokes)
+    : x(x), y(y), y_first(y_first), y_second(y_second), step(step), strokes(strokes) {}
+  constexpr int count() const { return strokes + 1; }
+  constexpr PatternPoint at(int i) const {
+    return PatternPoint{x + i * step, i == 0 ? y : ((i - 1) % 2 == 0 ? y_first : y_second), true};
+  }
+};
+
+// ============================================================================
+// JOINT TABLES
+// ============================================================================
+
+enum JointFlags {
+  JOINT_SKIP        = 0x01,  // Near the centre - not drawn
+  JOINT_UNREACHABLE = 0x02,  // Outside the arm's reach - not drawn, pattern reports failure
+  JOINT_STOP        = 0x04,  // Settle here before the next point
+  JOINT_EMPTY       = 0x08   // Unused centre-pass entry of a pattern table
+};
+
+/**
+ * @brief Precomputed goals of one pattern point
+ */
+struct JointPoint {
+  uint16_t polar;     // Polar arm goal (raw, home applied)
+  uint16_t platform;  // Platform goal within one turn (raw, home applied) - unwrapped at run time
+  uint8_t flags;      // JointFlags
+};
+
+/**
+ * @brief A built-in pattern, as executeStreakPattern() sees it
+ */
+struct StreakPattern {
+  const JointPoint* points;
+  uint16_t count;
+};
+
+/**
+ * @brief Pose reached after a point, carried along the pattern for the branch choice
+ */
+struct JointPose {
+  bool valid;   // A point has been solved so far
+  uint8_t flags;
+  PolarKinematics::angle_t lever;
+  PolarKinematics::angle_t platform;
+};
+
+constexpr JointPose pickPose(const PolarKinematics::Solution& solution, uint8_t pick, uint8_t flags) {
+  return JointPose{true, flags, solution.lever[pick], solution.platform[pick]};
+}
+
+constexpr JointPose nextPose(const PolarKinematics::SolveResult& solved, const PatternPoint& point,
+                             const JointPose& previous) {
+  return solved.result == PolarKinematics::SOLVED
+         ? pickPose(solved.solution,
+                    PolarKinematics::chooseSolution(solved.solution, previous.lever, previous.platform, !previous.valid),
+                    point.stop ? JOINT_STOP : 0)
+         : JointPose{previous.valid,
+                     (uint8_t)((solved.result == PolarKinematics::NEAR_CENTER ? JOINT_SKIP : JOINT_UNREACHABLE) |
+                               (point.stop ? JOINT_STOP : 0)),
+                     previous.lever, previous.platform};
+}
+
+constexpr JointPoint toJointPoint(const JointPose& pose) {
+  return JointPoint{
+    (uint16_t)((PolarKinematics::toTicks((uint16_t)pose.lever) + POLAR_ARM_HOME_TICKS) & 0x0FFF),
+    (uint16_t)((PolarKinematics::toTicks((uint16_t)pose.platform) + PLATFORM_HOME_TICKS) & 0x0FFF),
+    pose.flags};
+}
+
+/**
+ * @brief Pose after point I of a shape
+ *
+ * One instantiation per point, so each pose is evaluated once and the
+ * chain stays linear in the number of points.
+ */
+template <class Shape, const Shape& S, const PolarKinematics::Solver& K, int I>
+struct PoseChain {
+  static constexpr JointPose value =
+    nextPose(K.solveConst(S.at(I).x, S.at(I).y), S.at(I), PoseChain<Shape, S, K, I - 1>::value);
+};
+
+template <class Shape, const Shape& S, const PolarKinematics::Solver& K>
+struct PoseChain<Shape, S, K, -1> {
+  static constexpr JointPose value = JointPose{false, 0, 0, 0};
+};
+
+// ============================================================================
+// BRANCH PLAN
+// ============================================================================
+// planBranches() as template chains: PlanChain runs forward keeping the best
+// cost of each branch, PickChain runs backward from the last point reading
+// off the plan. Each is instantiated once per point.
+
+// BRANCH_PLAN_MODE (config.h) as the planner's criterion
+constexpr PolarKinematics::PlanCriterion PLAN_CRITERION =
+  BRANCH_PLAN_MODE == BRANCH_PLAN_PEAK ? PolarKinematics::PLAN_PEAK_STEP : PolarKinematics::PLAN_TOTAL_TRAVEL;
+
+/**
+ * @brief Planner state after a point
+ */
+struct PlanState {
+  bool valid;      // A point has been solved so far
+  uint8_t flags;   // JointFlags of this point
+  uint8_t from;    // As PlanPoint::from; 0x02 (each branch from itself) for points that are not solved
+  PolarKinematics::Solution solution;  // Last solved point
+  PolarKinematics::PlanCost cost[2];   // Best cost of ending on each of its branches
+};
+
+constexpr PolarKinematics::PlanCost viaBranch(const PlanState& previous, uint8_t a,
+                                              const PolarKinematics::Solution& solution, uint8_t b) {
+  return PolarKinematics::addStep(previous.cost[a],
+                                  PolarKinematics::stepCost(previous.solution.lever[a], previous.solution.platform[a],
+                                                            solution.lever[b], solution.platform[b]));
+}
+
+constexpr bool viaZero(const PlanState& previous, const PolarKinematics::Solution& solution, uint8_t b) {
+  return PolarKinematics::notWorse(viaBranch(previous, 0, solution, b), viaBranch(previous, 1, solution, b),
+                                   PLAN_CRITERION);
+}
+
+constexpr PolarKinematics::PlanCost reachBranch(const PlanState& previous, const PolarKinematics::Solution& solution,
+                                                uint8_t b) {
+  return !previous.valid ? PolarKinematics::firstCost(solution.platform[b])
+       : viaZero(previous, solution, b) ? viaBranch(previous, 0, solution, b)
+       : viaBranch(previous, 1, solution, b);
+}
+
+constexpr uint8_t reachFrom(const PlanState& previous, const PolarKinematics::Solution& solution) {
+  return !previous.valid ? 0 : (uint8_t)((viaZero(previous, solution, 0) ? 0 : 1) | (viaZero(previous, solution, 1) ? 0 : 2));
+}
+
+constexpr PlanState nextPlanState(const PolarKinematics::SolveResult& solved, const PatternPoint& point,
+                                  const PlanState& previous) {
+  return solved.result == PolarKinematics::SOLVED
+         ? PlanState{true, (uint8_t)(point.stop ? JOINT_STOP : 0), reachFrom(previous, solved.solution), solved.solution,
+                     {reachBranch(previous, solved.solution, 0), reachBranch(previous, solved.solution, 1)}}
+         : PlanState{previous.valid,
+                     (uint8_t)((solved.result == PolarKinematics::NEAR_CENTER ? JOINT_SKIP : JOINT_UNREACHABLE) |
+                               (point.stop ? JOINT_STOP : 0)),
+                     0x02, previous.solution, {previous.cost[0], previous.cost[1]}};
+}
+
+template <class Shape, const Shape& S, const PolarKinematics::Solver& K, int I>
+struct PlanChain {
+  static constexpr PlanState value =
+    nextPlanState(K.solveConst(S.at(I).x, S.at(I).y), S.at(I), PlanChain<Shape, S, K, I - 1>::value);
+};
+
+template <class Shape, const Shape& S, const PolarKinematics::Solver& K>
+struct PlanChain<Shape, S, K, -1> {
+  static constexpr PlanState value = PlanState{false, 0, 0, PolarKinematics::Solution{{0, 0}, {0, 0}}, {{0, 0}, {0, 0}}};
+};
+
+/**
+ * @brief Planned branch of the last solved point at or before point I
+ */
+template <class Shape, const Shape& S, const PolarKinematics::Solver& K, int I, bool LAST = (I + 1 >= S.count())>
+struct PickChain {
+  static constexpr uint8_t value =
+    (PlanChain<Shape, S, K, I + 1>::value.from >> PickChain<Shape, S, K, I + 1>::value) & 1;
+};
+
+template <class Shape, const Shape& S, const PolarKinematics::Solver& K, int I>
+struct PickChain<Shape, S, K, I, true> {
+  static constexpr uint8_t value =
+    PolarKinematics::notWorse(PlanChain<Shape, S, K, I>::value.cost[0], PlanChain<Shape, S, K, I>::value.cost[1],
+                              PLAN_CRITERION) ? 0 : 1;
+};
+
+constexpr JointPose planPose(const PlanState& state, uint8_t pick) {
+  return JointPose{state.valid, state.flags, state.solution.lever[pick], state.solution.platform[pick]};
+}
+
+/**
+ * @brief Pose of point I - planned, or greedy with BRANCH_PLAN_GREEDY
+ *
+ * A point that is not drawn keeps the pose of the last one that is.
+ */
+template <class Shape, const Shape& S, const PolarKinematics::Solver& K, int I,
+          bool GREEDY = (BRANCH_PLAN_MODE == BRANCH_PLAN_GREEDY)>
+struct TablePose {
+  static constexpr JointPose value = planPose(PlanChain<Shape, S, K, I>::value, PickChain<Shape, S, K, I>::value);
+};
+
+template <class Shape, const Shape& S, const PolarKinematics::Solver& K, int I>
+struct TablePose<Shape, S, K, I, true> {
+  static constexpr JointPose value = PoseChain<Shape, S, K, I>::value;
+};
+
+// ============================================================================
+// CENTRE PASS
+// ============================================================================
+// Each point gets two entries ahead of it for the centre poses of the
+// segment leading to it; they are JOINT_EMPTY where the segment keeps
+// clear of the centre.
+
+/**
+ * @brief Centre pass on the way to a drawn pose from the last one drawn before it
+ */
+constexpr PolarKinematics::CenterPassResult poseCenterPass(const PolarKinematics::Solver& solver, const JointPose& from,
+                                                           const JointPose& to) {
+  return from.valid && !(to.flags & (JOINT_SKIP | JOINT_UNREACHABLE)) &&
+         PolarKinematics::nearCenter(PolarKinematics::centerGate(solver, CENTER_PASS_RADIUS), from.lever, from.platform,
+                                     to.lever, to.platform)
+         ? PolarKinematics::centerPassConst(
+             solver, PolarKinematics::CenterMove{from.lever, from.platform, to.lever, to.platform}, CENTER_PASS_RADIUS)
+         : PolarKinematics::NO_CENTER_PASS;
+}
+
+constexpr JointPoint centerEntry(const PolarKinematics::CenterPassResult& pass, PolarKinematics::angle_t platform,
+                                 bool used) {
+  return used ? toJointPoint(JointPose{true, 0, pass.poses.lever, platform}) : JointPoint{0, 0, JOINT_EMPTY};
+}
+
+constexpr JointPoint tableEntry(const PolarKinematics::CenterPassResult& pass, const JointPose& pose, int slot) {
+  return slot == 0 ? centerEntry(pass, pass.poses.platform_in, pass.pass)
+       : slot == 1 ? centerEntry(pass, pass.poses.platform_out,
+                                 pass.pass && PolarKinematics::toTicks(pass.poses.platform_out) !=
+                                              PolarKinematics::toTicks(pass.poses.platform_in))
+       : toJointPoint(pose);
+}
+
+/**
+ * @brief Centre pass on the way to point I
+ */
+template <class Shape, const Shape& S, const PolarKinematics::Solver& K, int I>
+struct TablePass {
+  static constexpr PolarKinematics::CenterPassResult value =
+    poseCenterPass(K, TablePose<Shape, S, K, I - 1>::value, TablePose<Shape, S, K, I>::value);
+};
+
+/**
+ * @brief Table entry SLOT of point I: centre pose in, centre pose out, the point
+ */
+template <class Shape, const Shape& S, const PolarKinematics::Solver& K, int I, int SLOT>
+struct TablePoint {
+  static constexpr JointPoint value = tableEntry(TablePass<Shape, S, K, I>::value, TablePose<Shape, S, K, I>::value, SLOT);
+};
+
+// ============================================================================
+// TABLES
+// ============================================================================
+
+template <int... I>
+struct IndexList {};
+
+template <int N, int... I>
+struct MakeIndexList : MakeIndexList<N - 1, N - 1, I...> {};
+
+template <int... I>
+struct MakeIndexList<0, I...> {
+  typedef IndexList<I...> type;
+};
+
+// Three entries per shape point (see TablePoint)
+template <class Shape, const Shape& S, const PolarKinematics::Solver& K,
+          class Indices = typename MakeIndexList<3 * S.count()>::type>
+struct JointTable;
+
+template <class Shape, const Shape& S, const PolarKinematics::Solver& K, int... I>
+struct JointTable<Shape, S, K, IndexList<I...> > {
+  static constexpr uint16_t count = sizeof...(I);
+  static constexpr JointPoint points[sizeof...(I)] = {TablePoint<Shape, S, K, I / 3, I % 3>::value...};
+};
+
+template <class Shape, const Shape& S, const PolarKinematics::Solver& K, int... I>
+constexpr JointPoint JointTable<Shape, S, K, IndexList<I...> >::points[sizeof...(I)];
+
+// Table entry for a shape declared as a static constexpr object
+#define STREAK_PATTERN(shape, solver) \
+  { JointTable<decltype(shape), shape, solver>::points, JointTable<decltype(shape), shape, solver>::count }
+
+#endif // PATTERN_TABLES_H
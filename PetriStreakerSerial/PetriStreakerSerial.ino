@@ -44,6 +44,9 @@ void setup() {
 void loop() {
   // Process incoming serial commands from NUC (or serial monitor)
   commandHandler.processCommand();
+
+  // Keep the cached axis state fresh between commands
+  hardware.update();
   
   // Small delay to prevent overwhelming the serial port
   delay(10);
@@ -62,6 +65,7 @@ Serial Monitor Testing:
 - SUCTION ROT ON
 - LID OPEN
 - PATTERN 0
+- PATH BEGIN 1, PATH DATA 2EFB9411, PATH END, PATH RUN 1
 - HOME ALL
 - STATUS
 
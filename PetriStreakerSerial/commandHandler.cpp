@@ -8,7 +8,10 @@
 
 #include "CommandHandler.h"
 
-CommandHandler::CommandHandler(HardwareControl* hw) : hardware(hw) {}
+CommandHandler::CommandHandler(HardwareControl* hw) : hardware(hw), path_aborted(false) {
+  joint_origin[0] = 0;
+  joint_origin[1] = 0;
+}
 
 void CommandHandler::initialize() {
   DEBUG_SERIAL.println("=================================");
@@ -20,6 +23,10 @@ void CommandHandler::initialize() {
   DEBUG_SERIAL.println("PLATFORM LIFT [dir], SUCTION [state], LID [state]");
   DEBUG_SERIAL.println("FETCH, CUT, PATTERN [id], HOME ALL, STATUS, RESET");
   DEBUG_SERIAL.println("CYCLE START, ABORT, PAUSE, RESUME");
+  DEBUG_SERIAL.println("BUSSTATS, BUSSTATS RESET");
+  DEBUG_SERIAL.println("PATH BEGIN [id], PATH JOINT [id] [polar] [platform]");
+  DEBUG_SERIAL.println("PATH DATA [hex], PATH END, PATH RUN [id]");
+  DEBUG_SERIAL.println("PATH STATUS, PATH CLEAR");
   DEBUG_SERIAL.println("=================================");
 }
 
@@ -30,8 +37,11 @@ void CommandHandler::processCommand() {
     command.toUpperCase();
     
     if (command.length() > 0) {
-      DEBUG_SERIAL.print("Received: ");
-      DEBUG_SERIAL.println(command);
+      // Pattern data is too long and too frequent to echo
+      if (!command.startsWith("PATH DATA ")) {
+        DEBUG_SERIAL.print("Received: ");
+        DEBUG_SERIAL.println(command);
+      }
       
       executeCommand(command);
     }
@@ -99,6 +109,12 @@ void CommandHandler::executeCommand(String command) {
   else if (cmd == "EXTRUDE") {
     handleExtrudeCommand();
   }
+  else if (cmd == "BUSSTATS") {
+    handleBusStatsCommand(args);
+  }
+  else if (cmd == "PATH") {
+    handlePathCommand(args);
+  }
   else {
     DEBUG_SERIAL.println("UNKNOWN COMMAND");
   }
@@ -385,6 +401,7 @@ void CommandHandler::handleResetCommand() {
   DEBUG_SERIAL.println("Resetting system");
   
   // Reset operations - can be expanded
+  hardware->clearTrajectoryCache();
   hardware->homeAllAxes();
   DEBUG_SERIAL.println("RESET COMPLETED");
 }
@@ -421,4 +438,350 @@ void CommandHandler::handleExtrudeCommand() {
   // EXTRUDE
   bool success = hardware->extrude();  // Waits for completion
   DEBUG_SERIAL.println(success ? "EXTRUDE RDY" : "EXTRUDE FAILED");
-}
\ No newline at end of file
+}
+
+void CommandHandler::handleBusStatsCommand(String args) {
+  // BUSSTATS / BUSSTATS RESET
+  if (args == "RESET") {
+    hardware->resetBusStats();
+    DEBUG_SERIAL.println("BUSSTATS RESET");
+    return;
+  }
+  if (args.length() > 0) {
+    DEBUG_SERIAL.println("BUSSTATS INVALID ARGS");
+    return;
+  }
+
+  static const char* const names[BUS_INSTRUCTION_COUNT] = {"READ", "WRITE", "SYNC_READ", "SYNC_WRITE"};
+  const BusStats& stats = hardware->getBusStats();
+  uint32_t window_ms = millis() - stats.since_ms;
+  uint32_t busy_us = 0;
+
+  DEBUG_SERIAL.print("BUSSTATS BAUD ");
+  DEBUG_SERIAL.print(hardware->getBusBaudRate());
+  DEBUG_SERIAL.print(" WINDOW_MS ");
+  DEBUG_SERIAL.println(window_ms);
+
+  // One line per instruction type: counters, then the latency histogram
+  for (uint8_t i = 0; i < BUS_INSTRUCTION_COUNT; i++) {
+    const BusInstructionStats& s = stats.instruction[i];
+    busy_us += s.busy_us;
+
+    DEBUG_SERIAL.print(names[i]);
+    DEBUG_SERIAL.print(" PKT ");
+    DEBUG_SERIAL.print(s.packets);
+    DEBUG_SERIAL.print(" TX ");
+    DEBUG_SERIAL.print(s.tx_bytes);
+    DEBUG_SERIAL.print(" RX ");
+    DEBUG_SERIAL.print(s.rx_bytes);
+    DEBUG_SERIAL.print(" RETRY ");
+    DEBUG_SERIAL.print(s.retries);
+    DEBUG_SERIAL.print(" TIMEOUT ");
+    DEBUG_SERIAL.print(s.timeouts);
+    DEBUG_SERIAL.print(" CRC ");
+    DEBUG_SERIAL.print(s.crc_errors);
+    DEBUG_SERIAL.print(" ERR ");
+    DEBUG_SERIAL.print(s.other_errors);
+    DEBUG_SERIAL.print(" BUSY_US ");
+    DEBUG_SERIAL.print(s.busy_us);
+    DEBUG_SERIAL.print(" MAX_US ");
+    DEBUG_SERIAL.print(s.max_us);
+    DEBUG_SERIAL.print(" HIST");
+    for (uint8_t b = 0; b < BUS_LATENCY_BUCKETS; b++) {
+      DEBUG_SERIAL.print(b == 0 ? " " : ",");
+      DEBUG_SERIAL.print(s.latency[b]);
+    }
+    DEBUG_SERIAL.println();
+  }
+
+  // Scheduler view: bandwidth and queueing per priority class
+  static const char* const classes[BUS_CLASS_COUNT] = {"GOAL", "INTERLOCK", "TELEMETRY"};
+  for (uint8_t c = 0; c < BUS_CLASS_COUNT; c++) {
+    const BusClassStats& s = hardware->getBusClassStats((BusClass)c);
+
+    DEBUG_SERIAL.print("CLASS ");
+    DEBUG_SERIAL.print(classes[c]);
+    DEBUG_SERIAL.print(" TXN ");
+    DEBUG_SERIAL.print(s.transactions);
+    DEBUG_SERIAL.print(" FAIL ");
+    DEBUG_SERIAL.print(s.failures);
+    DEBUG_SERIAL.print(" BYTES ");
+    DEBUG_SERIAL.print(s.bytes);
+    DEBUG_SERIAL.print(" BUSY_US ");
+    DEBUG_SERIAL.print(s.busy_us);
+    DEBUG_SERIAL.print(" WAIT_US ");
+    DEBUG_SERIAL.print(s.wait_us);
+    DEBUG_SERIAL.print(" MAX_WAIT_US ");
+    DEBUG_SERIAL.print(s.max_wait_us);
+    DEBUG_SERIAL.print(" DEFERRED ");
+    DEBUG_SERIAL.print(s.deferred);
+    DEBUG_SERIAL.print(" LATE ");
+    DEBUG_SERIAL.println(s.late);
+  }
+
+  // Share of wall-clock time the bus was in use
+  DEBUG_SERIAL.print("BUS BUSY ");
+  DEBUG_SERIAL.print(window_ms > 0 ? (busy_us / 10.0f) / window_ms : 0.0f);
+  DEBUG_SERIAL.println("%");
+  DEBUG_SERIAL.println("BUSSTATS COMPLETED");
+}
+
+// ========================================================================
+// UPLOADED PATTERNS
+// ========================================================================
+//
+// PATH BEGIN <id>    Open a new pattern        -> PATH READY <id> <credits>
+// PATH JOINT <id> <polar> <platform>
+//                    Open a joint trajectory solved on the host, starting
+//                    from these raw goals (within one turn, home applied)
+//                                              -> PATH READY <id> <credits>
+// PATH DATA <hex>    Append up to PATH_DATA_MAX_POINTS points, each as
+//                    int16 x, int16 y (1/100 mm, little-endian), 8 hex digits.
+//                    Joint trajectories: steps from the previous goal, each
+//                    int8 polar, int8 platform, or 80 + int16 polar, int16
+//                    platform when a step does not fit in a byte
+// PATH END           No more points follow     -> PATH LOADED <id> <points>
+// PATH RUN <id>      Draw it                   -> PATH COMPLETED / PATH FAILED
+// PATH STATUS        -> PATH STATUS <id> <points> <free> <EMPTY|OPEN|ENDED>
+// PATH CLEAR         Drop the stored pattern   -> PATH CLEARED
+//
+// Flow control is by credits: the host starts with the credits from PATH
+// READY, spends one per point sent and gets more from "PATH CREDIT <n>" as
+// the running pattern frees slots. It may keep sending PATH DATA and the
+// final PATH END while PATH RUN is in progress, so a pattern longer than the
+// buffer is streamed through it. A pattern that was ended before it was run
+// stays in RAM and can be run again. Credits count points or joint steps.
+//
+// Joint trajectories bypass the on-board inverse kinematics - the board only
+// unwraps the platform turn count and writes the goals. They are produced by
+// Nuk/StreakTrajectory from the same Geometry.h.
+
+void CommandHandler::handlePathCommand(String args) {
+  int space = args.indexOf(' ');
+  String sub = (space > 0) ? args.substring(0, space) : args;
+  String value = (space > 0) ? args.substring(space + 1) : "";
+
+  if (sub == "BEGIN" || sub == "JOINT") {
+    if (sub == "JOINT") {
+      // <id> <polar> <platform>
+      int first = value.indexOf(' ');
+      int second = value.indexOf(' ', first + 1);
+      if (first < 0 || second < 0) {
+        DEBUG_SERIAL.println("PATH INVALID ARGS");
+        return;
+      }
+      joint_origin[0] = (uint16_t)value.substring(first + 1, second).toInt() & 0x0FFF;
+      joint_origin[1] = (uint16_t)value.substring(second + 1).toInt() & 0x0FFF;
+      path.begin((uint8_t)value.substring(0, first).toInt(), PathBuffer::JOINT);
+    } else {
+      path.begin((uint8_t)value.toInt());
+    }
+    DEBUG_SERIAL.print("PATH READY ");
+    DEBUG_SERIAL.print(path.getId());
+    DEBUG_SERIAL.print(" ");
+    DEBUG_SERIAL.println(path.space());
+  }
+  else if (sub == "DATA") {
+    appendPathData(value);
+  }
+  else if (sub == "END") {
+    if (!path.isOpen()) {
+      DEBUG_SERIAL.println("PATH NOT OPEN");
+      return;
+    }
+    path.end();
+    DEBUG_SERIAL.print("PATH LOADED ");
+    DEBUG_SERIAL.print(path.getId());
+    DEBUG_SERIAL.print(" ");
+    DEBUG_SERIAL.println(path.size());
+  }
+  else if (sub == "RUN") {
+    if (!path.isOpen() || value.length() == 0 || (uint8_t)value.toInt() != path.getId()) {
+      DEBUG_SERIAL.println("PATH UNKNOWN ID");
+      return;
+    }
+    DEBUG_SERIAL.print("Executing uploaded pattern: ");
+    DEBUG_SERIAL.println(path.getId());
+    bool success = runPath();
+    DEBUG_SERIAL.println(success ? "PATH COMPLETED" : "PATH FAILED");
+  }
+  else if (sub == "STATUS") {
+    DEBUG_SERIAL.print("PATH STATUS ");
+    DEBUG_SERIAL.print(path.getId());
+    DEBUG_SERIAL.print(" ");
+    DEBUG_SERIAL.print(path.size());
+    DEBUG_SERIAL.print(" ");
+    DEBUG_SERIAL.print(path.space());
+    DEBUG_SERIAL.println(!path.isOpen() ? " EMPTY" : path.isEnded() ? " ENDED" : " OPEN");
+  }
+  else if (sub == "CLEAR") {
+    path.clear();
+    DEBUG_SERIAL.println("PATH CLEARED");
+  }
+  else {
+    DEBUG_SERIAL.println("PATH INVALID ARGS");
+  }
+}
+
+/**
+ * @brief Store one PATH DATA line; only failures are answered
+ */
+void CommandHandler::appendPathData(String hex) {
+  switch (path.append(hex.c_str(), hex.length())) {
+    case PathBuffer::APPEND_INVALID:
+      DEBUG_SERIAL.println("PATH INVALID DATA");
+      break;
+    case PathBuffer::APPEND_OVERFLOW:
+      DEBUG_SERIAL.println("PATH OVERFLOW");
+      break;
+    case PathBuffer::APPEND_CLOSED:
+      DEBUG_SERIAL.println("PATH NOT OPEN");
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Draw the uploaded pattern through the path follower
+ *
+ * Cartesian points are solved here; joint steps are accumulated from
+ * joint_origin and written as they are. A resident Cartesian pattern is
+ * solved on its first run only - later runs replay the cached joint goals.
+ *
+ * A resident pattern is read in place and kept. Otherwise points are taken
+ * out as they are drawn, the freed slots are handed back as credits, and
+ * PATH DATA / PATH END lines are accepted between points until the end mark
+ * has been seen and the buffer is empty.
+ */
+bool CommandHandler::runPath() {
+  bool resident = path.isResident();
+  uint16_t total = path.size();
+  uint16_t index = 0;
+  uint16_t freed = 0;
+  uint32_t starved_ms = millis();
+  bool joint = (path.getKind() == PathBuffer::JOINT);
+  uint16_t polar = joint_origin[0];
+  uint16_t platform = joint_origin[1];
+  bool success = true;
+
+  bool recording = false;
+  if (resident && !joint) {
+    const float params[] = {(float)path.getId(), (float)path.getGeneration()};
+    uint32_t key = HardwareControl::trajectoryKey(HardwareControl::TRAJECTORY_UPLOAD, params, 2);
+    if (hardware->replayTrajectory(key, success)) {
+      return success;
+    }
+    hardware->recordTrajectory(key);
+    recording = true;
+  }
+
+  path_aborted = false;
+  if (joint) {
+    hardware->beginPath();
+  } else {
+    hardware->beginPlan();
+  }
+
+  while (!path_aborted) {
+    PathPoint point;
+    if (resident) {
+      if (index >= total) {
+        break;
+      }
+      point = path.at(index++);
+    } else {
+      servicePathStream();
+      if (!path.pop(point)) {
+        if (path.isEnded()) {
+          break;
+        }
+        // Buffer ran dry - hand back everything and wait for the host
+        reportPathCredit(freed);
+        if (millis() - starved_ms > PATH_STREAM_TIMEOUT_MS) {
+          DEBUG_SERIAL.println("PATH UNDERRUN");
+          success = false;
+          break;
+        }
+        hardware->update();
+        delay(1);
+        continue;
+      }
+      starved_ms = millis();
+      if (++freed >= PATH_CREDIT_BATCH) {
+        reportPathCredit(freed);
+      }
+    }
+
+    bool ok;
+    if (joint) {
+      polar = (polar + point.x) & 0x0FFF;
+      platform = (platform + point.y) & 0x0FFF;
+      ok = hardware->pathJointPoint(polar, platform);
+    } else {
+      // 1/100 mm to Q16.16 mm
+      ok = hardware->pathPointFixed((int32_t)point.x * 65536 / PATH_UNITS_PER_MM,
+                                    (int32_t)point.y * 65536 / PATH_UNITS_PER_MM);
+    }
+    if (!ok) {
+      success = false;
+    }
+  }
+  if (joint) {
+    hardware->endPath();
+  } else if (!hardware->endPlan(!path_aborted)) {
+    success = false;
+  }
+  if (recording) {
+    hardware->endTrajectoryRecord(!path_aborted);
+  }
+
+  if (path_aborted) {
+    DEBUG_SERIAL.println("OPERATION ABORTED");
+    success = false;
+  }
+  // A streamed pattern is gone once drawn - the host uploads it again
+  if (!resident) {
+    path.clear();
+  }
+  return success;
+}
+
+/**
+ * @brief Read the lines that arrived while a pattern is running
+ *
+ * Only pattern data, the end mark and ABORT are acted on; anything else is
+ * refused so the host knows to resend it after PATH COMPLETED.
+ */
+void CommandHandler::servicePathStream() {
+  while (DEBUG_SERIAL.available()) {
+    String line = DEBUG_SERIAL.readStringUntil('\n');
+    line.trim();
+    line.toUpperCase();
+
+    if (line.startsWith("PATH DATA ")) {
+      appendPathData(line.substring(10));
+    }
+    else if (line == "PATH END") {
+      path.end();
+    }
+    else if (line == "ABORT") {
+      path_aborted = true;
+    }
+    else if (line.length() > 0) {
+      DEBUG_SERIAL.println("PATH BUSY");
+    }
+  }
+}
+
+/**
+ * @brief Tell the host how many slots were freed since the last report
+ */
+void CommandHandler::reportPathCredit(uint16_t& freed) {
+  if (freed == 0) {
+    return;
+  }
+  DEBUG_SERIAL.print("PATH CREDIT ");
+  DEBUG_SERIAL.println(freed);
+  freed = 0;
+}
@@ -10,10 +10,14 @@
 #define COMMAND_HANDLER_H
 
 #include "Hardware.h"
+#include "PathBuffer.h"
 
 class CommandHandler {
 private:
   HardwareControl* hardware;
+  PathBuffer path;            // Uploaded pattern (PATH command)
+  bool path_aborted;          // ABORT received during PATH RUN
+  uint16_t joint_origin[2];   // Raw polar / platform goal the joint steps start from (PATH JOINT)
   
   // Command parsing and execution
   void executeCommand(String command);
@@ -37,6 +41,14 @@ private:
   void handleExtrudeCommand();
   void handlePauseCommand();
   void handleResumeCommand();
+  void handleBusStatsCommand(String args);
+  void handlePathCommand(String args);
+
+  // Uploaded pattern execution
+  void appendPathData(String hex);
+  bool runPath();
+  void servicePathStream();
+  void reportPathCredit(uint16_t& freed);
   
 public:
   CommandHandler(HardwareControl* hw);
@@ -7,9 +7,60 @@
 #define DEBUG_SERIAL  Serial
 #define DXL_SERIAL    Serial1
 #define SERIAL_BAUD_RATE 115200
-#define DXL_BAUD_RATE    57600
+#define DXL_BAUD_RATE    57600    // Factory default, also the fallback rate
 #define DXL_PROTOCOL 2.0
 
+// Dynamixel bus baud-rate negotiation (see HardwareControl::negotiateBaudRate)
+// Set DXL_TARGET_BAUD_RATE to DXL_BAUD_RATE to skip negotiation. The SAMD21
+// UART is reliable up to 3M; only use 4M after checking it on the bench.
+#define DXL_TARGET_BAUD_RATE 1000000
+#define DXL_SCAN_BAUD_RATES  {57600, 115200, 1000000, 2000000, 3000000, 4000000}
+
+// Dynamixel bus polling
+#define DXL_MOTOR_COUNT     8    // Number of Dynamixels on the bus
+#define DXL_USE_SYNC_READ   1    // 1 = poll all motors with one Sync Read, 0 = per-ID reads only
+#define DXL_PACKET_BUF_SIZE 128  // Scratch buffer for Sync Read/Write instruction packets
+
+// Non-blocking transport used by the background telemetry refresh
+#define DXL_TRANSPORT_RX_SIZE    256   // Status bytes one transaction may return (8 x telemetry = 200)
+#define DXL_TRANSPORT_TIMEOUT_US 3000  // Status slack on top of the replies' wire time (from the end of the instruction)
+#define DXL_UART_RX_RING         64    // Core UART RX ring (SERIAL_BUFFER_SIZE) - caps background reads
+
+// Bus scheduler (goal writes > interlock reads > telemetry)
+#define BUS_QUEUE_SIZE       6      // Transactions that can be queued at once
+#define BUS_AGING_US         50000  // Queued this long, a request is treated one class higher
+#define BUS_TURNAROUND_US    20     // Per-status allowance on top of wire time and return delay
+#define BUS_GOAL_DEADLINE_US      1000  // Goal writes should be on the wire within this
+#define BUS_INTERLOCK_DEADLINE_US 3000  // Interlock/moving reads should complete within this
+
+// Bus latency profile applied at initialize()
+#define DXL_RETURN_DELAY_TIME   0  // Return Delay Time in 2 us units (factory default 250 = 500 us)
+#define DXL_STATUS_RETURN_LEVEL 1  // 2 = status for every instruction, 1 = PING/READ only (fire-and-forget writes)
+
+// Bus instrumentation (BUSSTATS command)
+#define BUS_LATENCY_BUCKETS   8   // Histogram bins, upper bounds in BUS_LATENCY_BOUNDS_US
+#define BUS_LATENCY_BOUNDS_US {250, 500, 1000, 2000, 5000, 10000, 20000}  // Last bin is open-ended
+
+// Dynamixel X-series control table addresses (Protocol 2.0)
+#define ADDR_MOVING          122  // Moving flag (1 byte)
+#define ADDR_MOVING_STATUS   123  // Moving Status bitfield (1 byte), follows MOVING
+#define ADDR_RETURN_DELAY_TIME  9  // Return Delay Time (1 byte, torque off to write)
+#define ADDR_DRIVE_MODE       10  // Drive Mode (1 byte, torque off to write)
+#define ADDR_HOMING_OFFSET    20  // Homing Offset (4 bytes, torque off to write)
+#define ADDR_OPERATING_MODE   11  // Operating Mode (1 byte, torque off to write)
+#define ADDR_TORQUE_ENABLE    64  // Torque Enable (1 byte)
+#define ADDR_STATUS_RETURN_LEVEL 68 // Status Return Level (1 byte)
+#define ADDR_PROFILE_ACCELERATION 108 // Profile Acceleration (4 bytes)
+#define ADDR_PROFILE_VELOCITY 112 // Profile Velocity (4 bytes)
+#define ADDR_GOAL_POSITION   116  // Goal Position (4 bytes)
+#define ADDR_HARDWARE_ERROR   70  // Hardware Error Status (1 byte)
+#define ADDR_PRESENT_CURRENT 126  // Present Current / Present Load (2 bytes)
+#define ADDR_PRESENT_VELOCITY 128 // Present Velocity (4 bytes)
+#define ADDR_PRESENT_POSITION 132 // Present Position (4 bytes)
+#define ADDR_PRESENT_TEMPERATURE 146 // Present Temperature (1 byte)
+#define ADDR_INDIRECT_ADDRESS_1  168 // Indirect Address 1 (2 bytes per entry, torque off to write)
+#define ADDR_INDIRECT_DATA_1     224 // Indirect Data 1 (1 byte per entry)
+
 // Motor IDs
 #define DXL_LID_LIFTER   1  // Lid Lifer / lever motor ID
 #define DXL_POLAR_ARM    2  // Polar arm / lever motor ID
@@ -30,11 +81,8 @@
 
 // Geometry & homes (in raw units, 0–4095)
 #define LID_LIFTER_HOME   3849.0f
-#define POLAR_ARM_LENGTH   98.995f  // Polar arm length [mm]
-//#define POLAR_ARM_HOME    (178.51f/360.0f*4096.0f)  // DO NOT MODIFY USEFUL FOR CALCULATIONS - DO NOT GO THERE
-#define POLAR_ARM_HOME    (0.51f/360.0f*4096.0f)  // DO NOT MODIFY USEFUL FOR CALCULATIONS - DO NOT GO THERE
+#include "Geometry.h"  // Drawing geometry - shared with the host trajectory tool
 #define POLAR_ARM_NO_OBSTRUCT_HOME (236.25f/360.0f*4096.0f) // ACTUAL POSITION TO RES      T
-#define PLATFORM_HOME     1238.0f  // Platform home position to not obstruct 
 #define HANDLER_HOME      1947.0f  // Platform home position means that it goes to cartridge. Middle is 1705 units 2112. New is 1540 so 407 units
 #define RESTACKER_HOME    2800.0f  // Restacker position down
 #define CARTRIDGE1_HOME   1500.0f  // C1 position down
@@ -90,6 +138,7 @@ top: 6000, up: 4900, mid: 4300, down: 2700.  HANDLER 1120
 #define LID_LIFTER_SPEED    50   // Extruder movement speed
 #define POLAR_ARM_SPEED     100  // Polar arm movement speed
 #define PLATFORM_SPEED      100  // Platform movement speed
+#define PLATFORM_MAX_TURNS  64   // Turns the platform may drift from home before homing folds them into its Homing Offset
 #define HANDLER_SPEED       100  // Handler movement speed
 #define HANDLER_ACCEL       20   // Handler Accel
 #define RESTACKER_SPEED    100  // Restacker position down
@@ -102,6 +151,64 @@ top: 6000, up: 4900, mid: 4300, down: 2700.  HANDLER 1120
 #define HOME_TIMEOUT     5000  // Maximum time for homing operation
 #define DISH_LOAD_TIMEOUT 3000 // Maximum time for dish loading
 
+// Axis state table (background telemetry cache)
+#define AXIS_STATE_REFRESH_MS  100  // Period of the batched refresh from loop()
+#define AXIS_STATE_MAX_AGE_MS  250  // Older cached state is re-read before use
+
+// Motion groups (wait only on the commanded axes)
+#define MOTION_POLL_MS          5     // Period of the group Moving/position poll
+#define MOTION_GOAL_TOLERANCE   20    // Ticks from goal that count as arrived
+#define MOTION_START_GRACE_MS   100   // Before this, a stopped axis away from its goal may not have started yet
+
+// Coordinated drawing segments (polar arm + platform arrive together)
+#define COORDINATED_SEGMENTS    1     // 0 = both axes use their own fixed profile
+#define SEGMENT_VELOCITY        160   // Profile velocity of the axis with the longest move
+#define SEGMENT_ACCEL           40    // Its profile acceleration (0 = no ramp)
+
+// Streaming path follower for drawing patterns
+#define PATH_FOLLOW_STOP        0     // Stop and settle at every point
+#define PATH_FOLLOW_WINDOW      1     // Next goal once the axes are within PATH_FOLLOW_TOLERANCE
+#define PATH_FOLLOW_TICK        2     // Next goal every PATH_TICK_MS
+#define PATH_FOLLOW_MODE        PATH_FOLLOW_WINDOW
+#define PATH_FOLLOW_TOLERANCE   60    // Ticks from the current goal at which the next one is sent
+#define PATH_TICK_MS            40    // Goal period in tick mode
+#define PATH_QUEUE_DEPTH        16    // Solved goals that may wait for the bus while the next points are solved
+
+// Adaptive point placement for drawLine/Circle/Spiral/Flower (see ChordSubdivision.h)
+#define CHORD_TOLERANCE_MM      0.2f  // Largest stylus deviation between points; 0 = fixed num_points sampling
+#define CHORD_SEGMENTS_PER_TURN 4     // Starting spans per turn of a closed curve, before subdivision
+
+// Continuous spiral (drawSpiral, streak pattern 1): one platform move at constant speed, arm following its position
+#define SPIRAL_CONTINUOUS       1     // 0 = discrete position goals (num_points, flash table)
+#define SPIRAL_PLATFORM_RPM     10.0f // Platform speed - a spiral takes revolutions / rpm minutes
+#define SPIRAL_ARM_PERIOD_MS    20    // Polar arm goal update period
+
+// Arm/platform branch choice for Cartesian patterns (see BranchPlanner.h)
+#define BRANCH_PLAN_GREEDY      0     // Per point, against the previous point only
+#define BRANCH_PLAN_TOTAL       1     // Whole pattern: least total joint travel
+#define BRANCH_PLAN_PEAK        2     // Whole pattern: smallest largest step, then least travel
+#define BRANCH_PLAN_MODE        BRANCH_PLAN_TOTAL
+#define BRANCH_PLAN_POINTS      64    // Plan window (12 bytes per point) - the oldest points are drawn once it is full
+#define BRANCH_PLAN_LOOKAHEAD   32    // Points kept in the window to be planned again with the ones after them
+
+// Solved-trajectory cache (parametric draws and resident uploads, replayed for later dishes)
+#define TRAJECTORY_CACHE_SLOTS  4     // Patterns kept at once (least recently used is replaced)
+#define TRAJECTORY_CACHE_POINTS 200   // Points per pattern (6 bytes each) - longer ones are not cached
+
+// Uploaded patterns (PATH command - points streamed from the host)
+#define PATH_BUFFER_POINTS      512   // Ring buffer capacity (4 bytes per point)
+#define PATH_UNITS_PER_MM       100   // Point coordinates are int16 in 1/100 mm
+#define PATH_DATA_MAX_POINTS    32    // Points per PATH DATA line (8 hex digits each; joint steps are 4 or 10)
+#define PATH_CREDIT_BATCH       64    // Freed slots reported to the host at once while running
+#define PATH_STREAM_TIMEOUT_MS  2000  // Empty buffer this long before the end mark = stream lost
+
+// Hardware error recovery
+#define DXL_ERR_HARDWARE_ALERT  0x80  // Status packet error bit - Hardware Error Status is set
+#define FAULT_REBOOT_TIMEOUT_MS 2000  // Time allowed for a rebooted motor to answer a ping
+#define FAULT_PING_INTERVAL_MS  50    // Ping period while waiting for the reboot
+#define DXL_TICKS_PER_TURN      4096  // Encoder ticks per output revolution (X-series)
+#define DXL_VELOCITY_UNIT_RPM   0.229f // Profile / Goal Velocity unit (X-series)
+
 // Determine The Pins for Solenoid Valves and Diaphrams
 //#define LID_SUCTION 5
 //#define LID_SOLENOID 6
@@ -6,55 +6,203 @@
  */
 
 #include "Hardware.h"
+#include "PatternTables.h"
+#include <ChordSubdivision.h>
+#include <CenterPass.h>
 #include <math.h>
 #include <Servo.h>
 
+// Protocol 2.0 Sync Write instruction, as reported by the scheduler
+static const uint8_t INST_SYNC_WRITE = 0x83;
+
+// Background telemetry reads sized so one response fits the UART RX ring
+static const uint8_t TELEMETRY_PER_READ =
+  (DXL_UART_RX_RING / (11 + sizeof(MotorTelemetry)) > 0) ? DXL_UART_RX_RING / (11 + sizeof(MotorTelemetry)) : 1;
+
+// Every Dynamixel on the bus, in the order used by the Sync Read poll
+static const uint8_t MOTOR_IDS[DXL_MOTOR_COUNT] = {
+  DXL_LID_LIFTER, DXL_POLAR_ARM, DXL_PLATFORM, DXL_HANDLER,
+  DXL_RESTACKER, DXL_CARTRIDGE1, DXL_CARTRIDGE2, DXL_CARTRIDGE3
+};
+
+// Per-motor setup, in MOTOR_IDS order - applied at initialize() and after a fault reboot
+struct MotorSetup {
+  uint8_t mode;       // Operating mode
+  int32_t velocity;   // Profile velocity
+  int32_t accel;      // Profile acceleration (0 = leave the motor's value)
+};
+static const MotorSetup MOTOR_SETUP[DXL_MOTOR_COUNT] = {
+  {OP_POSITION,          LID_LIFTER_SPEED, 0},              // Lid lifter
+  {OP_POSITION,          POLAR_ARM_SPEED,  0},              // Polar arm
+  {OP_EXTENDED_POSITION, PLATFORM_SPEED,   0},              // Platform - extended to avoid discontinuities
+  {OP_EXTENDED_POSITION, HANDLER_SPEED,    HANDLER_ACCEL},  // Handler
+  {OP_EXTENDED_POSITION, RESTACKER_SPEED,  0},              // Restacker
+  {OP_EXTENDED_POSITION, CARTRIDGE1_SPEED, 0},              // Cartridge 1
+  {OP_EXTENDED_POSITION, CARTRIDGE2_SPEED, 0},              // Cartridge 2
+  {OP_EXTENDED_POSITION, CARTRIDGE3_SPEED, 0}               // Cartridge 3
+};
+
+// Cartridge lifts plus restacker, moved together by the LIFT ALL / home commands
+static const uint8_t CARTRIDGE_STACK_IDS[4] = {
+  DXL_CARTRIDGE1, DXL_CARTRIDGE2, DXL_CARTRIDGE3, DXL_RESTACKER
+};
+
+// Extended position axes with a fixed travel, and the middle of it - homing
+// gives each the turn count that puts it nearest there (see syncTravelTurns())
+static const uint8_t TRAVEL_AXIS_IDS[5] = {
+  DXL_HANDLER, DXL_RESTACKER, DXL_CARTRIDGE1, DXL_CARTRIDGE2, DXL_CARTRIDGE3
+};
+static const int32_t TRAVEL_MIDDLE[5] = {
+  (int32_t)((HANDLER_C3 + HANDLER_RESTACKER) / 2),
+  (int32_t)((RESTACKER_HOME + RESTACKER_TOP) / 2),
+  (int32_t)((CARTRIDGE1_HOME + CARTRIDGE1_TOP) / 2),
+  (int32_t)((CARTRIDGE2_HOME + CARTRIDGE2_TOP) / 2),
+  (int32_t)((CARTRIDGE3_HOME + CARTRIDGE3_TOP) / 2)
+};
+
+/**
+ * @brief Nearest whole number of turns in a tick difference
+ */
+static int32_t nearestTurns(int32_t delta) {
+  return (delta >= 0) ? (delta + DXL_TICKS_PER_TURN / 2) / DXL_TICKS_PER_TURN
+                      : -((-delta + DXL_TICKS_PER_TURN / 2) / DXL_TICKS_PER_TURN);
+}
+
+// Arm/platform inverse kinematics, geometry folded at compile time
+static constexpr PolarKinematics::Solver KINEMATICS(PLATFORM_CENTER_X, PLATFORM_CENTER_Y, POLAR_ARM_LENGTH,
+                                                    PLATFORM_RADIUS, POINT_MIN_RADIUS);
+
+// Arm band and platform swing beyond which a segment cannot need a centre pass
+static constexpr PolarKinematics::CenterGate CENTER_GATE = PolarKinematics::centerGate(KINEMATICS, CENTER_PASS_RADIUS);
+
+// FNV-1a step over one 32-bit word (trajectory cache keys)
+static constexpr uint32_t mixKey(uint32_t key, uint32_t word) {
+  return (key ^ word) * 16777619UL;
+}
+
+// Geometry and homes the cached trajectories were solved for. Part of every
+// cache key, so a sequence solved for other numbers is never replayed.
+static constexpr uint32_t GEOMETRY_VERSION =
+  mixKey(mixKey(mixKey(mixKey(mixKey(mixKey(mixKey(2166136261UL,
+    (uint32_t)PolarKinematics::toQ16(PLATFORM_CENTER_X)), (uint32_t)PolarKinematics::toQ16(PLATFORM_CENTER_Y)),
+    (uint32_t)PolarKinematics::toQ16(POLAR_ARM_LENGTH)), (uint32_t)PolarKinematics::toQ16(PLATFORM_RADIUS)),
+    (uint32_t)PolarKinematics::toQ16(POINT_MIN_RADIUS)), (uint32_t)POLAR_ARM_HOME_TICKS),
+    (uint32_t)PLATFORM_HOME_TICKS);
+
+/**
+ * @brief Feeds subdivided curve points to the path follower
+ */
+struct PathPointSink {
+  HardwareControl* hardware;
+  bool success;
+  void point(float x, float y) {
+    if (!hardware->pathPoint(x, y)) {
+      success = false;
+    }
+  }
+};
+
+/**
+ * @brief Stream a curve with only the points CHORD_TOLERANCE_MM calls for
+ * @param segments Starting spans before subdivision
+ */
+template <class Curve>
+static bool streamCurve(HardwareControl& hardware, const Curve& curve, uint8_t segments) {
+  PathPointSink sink = {&hardware, true};
+  PolarKinematics::subdivideChords(KINEMATICS, curve, CHORD_TOLERANCE_MM, segments, sink);
+  return sink.success;
+}
+
+// Built-in streak patterns, solved to joint tables at compile time (see PatternTables.h)
+static constexpr LineShape STREAK_LINE(-40, 0, 40, 0, 60);
+static constexpr SpiralShape STREAK_SPIRAL(20, 2, 50);
+static constexpr SquareShape STREAK_QUADRANT(25, 20);
+static constexpr ZigzagShape STREAK_ZIGZAG(-30, -30, 30, -30, 10, 6);
+static constexpr LineShape STREAK_DEFAULT(-30, 0, 30, 0, 30);
+
+static const StreakPattern STREAK_PATTERNS[] = {
+  STREAK_PATTERN(STREAK_LINE, KINEMATICS),      // 0: Simple 3-streak pattern
+  STREAK_PATTERN(STREAK_SPIRAL, KINEMATICS),    // 1: Spiral streak
+  STREAK_PATTERN(STREAK_QUADRANT, KINEMATICS),  // 2: Quadrant streak
+  STREAK_PATTERN(STREAK_ZIGZAG, KINEMATICS),    // 3: Zigzag streak
+  STREAK_PATTERN(STREAK_DEFAULT, KINEMATICS)    // Any other ID
+};
+static const uint8_t STREAK_PATTERN_COUNT = sizeof(STREAK_PATTERNS) / sizeof(STREAK_PATTERNS[0]);
+static const uint8_t STREAK_SPIRAL_ID = 1;  // Drawn by drawSpiral() instead with SPIRAL_CONTINUOUS
+
 /**
  * @brief Constructor - Initialize hardware control object
  */
 HardwareControl::HardwareControl()
-  : dxl(DXL_SERIAL, DXL_DIR_PIN) {
-  current_polar_angle = 0.0f;
-  current_platform_angle = 0.0f;
+  : dxl(DXL_SERIAL, DXL_DIR_PIN), transport(DXL_SERIAL, DXL_DIR_PIN), scheduler(transport) {
+  current_polar_angle = 0;
+  current_platform_angle = 0;
   is_initialized = false;
   first_move = true;
+  dxl_baud_rate = DXL_BAUD_RATE;
+  status_return_level = 2;  // Factory default - every instruction is acknowledged
+
+  // Axis state table starts empty until the first refresh
+  for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+    axis_position[i] = 0;
+    axis_goal[i] = 0;
+    axis_turn_offset[i] = 0;
+    axis_moving[i] = 0;
+    axis_load[i] = 0;
+  }
+  axis_state_ms = 0;
+  axis_state_valid = false;
+
+  // Nothing is known about the control tables until primeShadow()
+  memset(shadow, 0, sizeof(shadow));
+
+  resetBusStats();
+
+  profile_override = 0;
+  path_active = false;
+  path_sent_ms = 0;
+  path_poll_ms = 0;
+  path_queue_head = 0;
+  path_queue_count = 0;
+  path_send_failed = false;
+  path_tail[0] = 0;
+  path_tail[1] = 0;
+  recording_slot = -1;
+  recording_overflow = false;
+  planning = false;
+  plan_count = 0;
+  clearTrajectoryCache();
+
+  fault_pending = 0;
+  in_recovery = false;
 
   // Initialize extended position tracking for platform motor
-  cumulative_platform_degrees = 0.0f;
-  last_platform_degrees = 0.0f;
+  cumulative_platform_ticks = 0;
+  last_platform_ticks = 0;
 
-  // Platform geometry settings
-  platform_center_x = 70.0f;  // Cx
-  platform_center_y = 70.0f;  // Cy
-  platform_radius = 45.0f;    // Rplat
+  memset(moving_sync_data, 0, sizeof(moving_sync_data));
+  memset(&telemetry, 0, sizeof(telemetry));
+  telemetry_next = 0;
+  telemetry_in_flight = false;
+  telemetry_sweep_received = 0;
+  telemetry_sweep_ms = 0;
+
+  scheduler.setObserver(&HardwareControl::onBusTransaction, this);
 }
 
 /**
  * @brief Extended position tracking for platform motor to avoid discontinuities
+ * @param target_ticks Platform goal within one turn (raw)
+ * @return Goal on the extended (multi-turn) scale, reached the short way round
  */
-int32_t HardwareControl::extendedPlatformPosition(float target_degrees) {
-  // Calculate the angular difference
-  float diff = target_degrees - last_platform_degrees;
-
-  // Normalize to [-180, 180] to find shortest path
-  while (diff > 180.0f) diff -= 360.0f;
-  while (diff < -180.0f) diff += 360.0f;
-
-  // Update cumulative angle
-  cumulative_platform_degrees += diff;
-  last_platform_degrees = target_degrees;
-
-  // Convert to raw position (can exceed 4095)
-  int32_t raw_position = (int32_t)((cumulative_platform_degrees / 360.0f) * 4096.0f);
+int32_t HardwareControl::extendedPlatformTicks(int32_t target_ticks) {
+  // Shortest way from the last target, in [-half turn, half turn)
+  int32_t diff = ((target_ticks - last_platform_ticks + DXL_TICKS_PER_TURN / 2) & (DXL_TICKS_PER_TURN - 1)) -
+                 DXL_TICKS_PER_TURN / 2;
 
-  DEBUG_SERIAL.print("Platform: target=");
-  DEBUG_SERIAL.print(target_degrees);
-  DEBUG_SERIAL.print("°, cumulative=");
-  DEBUG_SERIAL.print(cumulative_platform_degrees);
-  DEBUG_SERIAL.print("°, raw=");
-  DEBUG_SERIAL.println(raw_position);
-
-  return raw_position;
+  cumulative_platform_ticks += diff;
+  last_platform_ticks = target_ticks;
+  return cumulative_platform_ticks;
 }
 
 /**
@@ -66,56 +214,25 @@ void HardwareControl::initialize() {
   // Initialize I2C for extruder control
   //Wire.begin();
 
-  // Initialize Dynamixel
-  dxl.begin(DXL_BAUD_RATE);
-  dxl.setPortProtocolVersion(2.0);
-
-  // Initialize lid lifter motor
-  dxl.torqueOff(DXL_LID_LIFTER);
-  dxl.setOperatingMode(DXL_LID_LIFTER, OP_POSITION);
-  dxl.torqueOn(DXL_LID_LIFTER);
-  dxl.writeControlTableItem(ControlTableItem::PROFILE_VELOCITY, DXL_LID_LIFTER, LID_LIFTER_SPEED);
-
-  // Initialize polar arm motor
-  dxl.torqueOff(DXL_POLAR_ARM);
-  dxl.setOperatingMode(DXL_POLAR_ARM, OP_POSITION);
-  dxl.torqueOn(DXL_POLAR_ARM);
-  dxl.writeControlTableItem(ControlTableItem::PROFILE_VELOCITY, DXL_POLAR_ARM, POLAR_ARM_SPEED);
-
-  // Initialize platform motor with EXTENDED POSITION MODE to avoid discontinuities
-  dxl.torqueOff(DXL_PLATFORM);
-  dxl.setOperatingMode(DXL_PLATFORM, OP_EXTENDED_POSITION);  // Changed to extended position
-  dxl.torqueOn(DXL_PLATFORM);
-  dxl.writeControlTableItem(ControlTableItem::PROFILE_VELOCITY, DXL_PLATFORM, PLATFORM_SPEED);
-
-  // Initialize handler motor
-  dxl.torqueOff(DXL_HANDLER);
-  dxl.setOperatingMode(DXL_HANDLER, OP_EXTENDED_POSITION);
-  dxl.torqueOn(DXL_HANDLER);
-  dxl.writeControlTableItem(ControlTableItem::PROFILE_VELOCITY, DXL_HANDLER, HANDLER_SPEED);
-  dxl.writeControlTableItem(ControlTableItem::PROFILE_ACCELERATION, DXL_HANDLER, HANDLER_ACCEL);
-
-  // Initialize restacker motor
-  dxl.torqueOff(DXL_RESTACKER);
-  dxl.setOperatingMode(DXL_RESTACKER, OP_EXTENDED_POSITION);
-  dxl.torqueOn(DXL_RESTACKER);
-  dxl.writeControlTableItem(ControlTableItem::PROFILE_VELOCITY, DXL_RESTACKER, RESTACKER_SPEED);
-
-  // Initialize Cartridge motors
-  dxl.torqueOff(DXL_CARTRIDGE1);
-  dxl.setOperatingMode(DXL_CARTRIDGE1, OP_EXTENDED_POSITION);
-  dxl.torqueOn(DXL_CARTRIDGE1);
-  dxl.writeControlTableItem(ControlTableItem::PROFILE_VELOCITY, DXL_CARTRIDGE1, CARTRIDGE1_SPEED);
-
-  dxl.torqueOff(DXL_CARTRIDGE2);
-  dxl.setOperatingMode(DXL_CARTRIDGE2, OP_EXTENDED_POSITION);
-  dxl.torqueOn(DXL_CARTRIDGE2);
-  dxl.writeControlTableItem(ControlTableItem::PROFILE_VELOCITY, DXL_CARTRIDGE2, CARTRIDGE2_SPEED);
-
-  dxl.torqueOff(DXL_CARTRIDGE3);
-  dxl.setOperatingMode(DXL_CARTRIDGE3, OP_EXTENDED_POSITION);
-  dxl.torqueOn(DXL_CARTRIDGE3);
-  dxl.writeControlTableItem(ControlTableItem::PROFILE_VELOCITY, DXL_CARTRIDGE3, CARTRIDGE3_SPEED);
+  // Initialize Dynamixel bus at the fastest rate every motor accepts
+  dxl.setPortProtocolVersion(DXL_PROTOCOL);
+  transport.begin();
+  dxl_baud_rate = negotiateBaudRate();
+  scheduler.setBaudRate(dxl_baud_rate);
+
+  // Learn what the motors already hold so unchanged items are not rewritten
+  primeShadow();
+
+  // Operating mode, telemetry map and profile of every motor (see MOTOR_SETUP)
+  for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+    if (MOTOR_SETUP[i].mode == OP_EXTENDED_POSITION) {
+      clearHomingTurns(MOTOR_IDS[i]);
+    }
+    configureMotor(MOTOR_IDS[i]);
+  }
+
+  // Latency profile - from here on goal writes are fire-and-forget
+  applyStatusReturnLevel(DXL_STATUS_RETURN_LEVEL);
 
   // Initialize servo pins (check if these are defined in config.h)
   // servo1.attach(SERVO1_PIN);  // Uncomment if servo pins are defined
@@ -140,6 +257,129 @@ void HardwareControl::initialize() {
   DEBUG_SERIAL.println("Hardware initialization complete");
 }
 
+/**
+ * @brief Apply operating mode, telemetry map, return delay and profile to one motor
+ *
+ * Goes through writeRegister(), so items the shadow already holds are skipped.
+ */
+void HardwareControl::configureMotor(uint8_t motorId) {
+  int8_t idx = motorIndex(motorId);
+  if (idx < 0) {
+    return;
+  }
+  const MotorSetup& setup = MOTOR_SETUP[idx];
+
+  // EEPROM items and the indirect address map need torque off
+  writeRegister(motorId, ADDR_TORQUE_ENABLE, 0, 1);
+  mapTelemetryBlock(motorId);
+  writeRegister(motorId, ADDR_RETURN_DELAY_TIME, DXL_RETURN_DELAY_TIME, 1);
+  writeRegister(motorId, ADDR_OPERATING_MODE, setup.mode, 1);
+  writeRegister(motorId, ADDR_TORQUE_ENABLE, 1, 1);
+  writeRegister(motorId, ADDR_PROFILE_VELOCITY, setup.velocity, 4);
+  if (setup.accel > 0) {
+    writeRegister(motorId, ADDR_PROFILE_ACCELERATION, setup.accel, 4);
+  }
+}
+
+/**
+ * @brief Drop whole turns an earlier run left in Homing Offset
+ *
+ * Turn counts are kept in RAM (axis_turn_offset); Homing Offset is EEPROM and
+ * only keeps the part within half a turn, so goals mean the same after every
+ * power cycle. Writing it needs torque off.
+ */
+void HardwareControl::clearHomingTurns(uint8_t motorId) {
+  int32_t offset = 0;
+  if (!busRead(motorId, ADDR_HOMING_OFFSET, 4, offset)) {
+    return;
+  }
+  int32_t baseline = ((offset + DXL_TICKS_PER_TURN / 2) & (DXL_TICKS_PER_TURN - 1)) - DXL_TICKS_PER_TURN / 2;
+  if (baseline != offset) {
+    writeRegister(motorId, ADDR_TORQUE_ENABLE, 0, 1);
+    writeRegister(motorId, ADDR_HOMING_OFFSET, baseline, 4);
+  }
+}
+
+/**
+ * @brief Find every motor, move the bus to DXL_TARGET_BAUD_RATE and verify it
+ *
+ * Each motor is looked for at the target rate first (already migrated on a
+ * previous boot), then at the other DXL_SCAN_BAUD_RATES. Motors found at a
+ * different rate are switched to the target. If any ID does not answer a
+ * ping at the target rate, every motor is moved back to DXL_BAUD_RATE.
+ * @return Baud rate the bus is running at
+ */
+uint32_t HardwareControl::negotiateBaudRate() {
+  if (DXL_TARGET_BAUD_RATE == DXL_BAUD_RATE) {
+    dxl.begin(DXL_BAUD_RATE);
+    DEBUG_SERIAL.print("Dynamixel bus at ");
+    DEBUG_SERIAL.print((uint32_t)DXL_BAUD_RATE);
+    DEBUG_SERIAL.println(" bps (negotiation disabled)");
+    return DXL_BAUD_RATE;
+  }
+
+  const uint32_t scan_rates[] = DXL_SCAN_BAUD_RATES;
+  const uint8_t rate_count = sizeof(scan_rates) / sizeof(scan_rates[0]);
+  bool found[DXL_MOTOR_COUNT] = {false};
+
+  // Locate each motor, target rate first
+  for (int8_t r = -1; r < rate_count; r++) {
+    uint32_t rate = (r < 0) ? (uint32_t)DXL_TARGET_BAUD_RATE : scan_rates[r];
+    if (r >= 0 && rate == DXL_TARGET_BAUD_RATE) {
+      continue;
+    }
+    dxl.begin(rate);
+
+    for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+      if (found[i] || !busPing(MOTOR_IDS[i])) {
+        continue;
+      }
+      found[i] = true;
+      if (rate != DXL_TARGET_BAUD_RATE) {
+        // Baud Rate lives in EEPROM - torque must be off to change it
+        writeRegister(MOTOR_IDS[i], ADDR_TORQUE_ENABLE, 0, 1);
+        uint32_t start_us = micros();
+        bool ok = dxl.setBaudrate(MOTOR_IDS[i], DXL_TARGET_BAUD_RATE);
+        recordBusTransfer(BUS_WRITE, start_us, 13, ok ? 11 : 0, ok);
+      }
+    }
+  }
+
+  // Verify every motor at the target rate
+  dxl.begin(DXL_TARGET_BAUD_RATE);
+  bool all_ok = true;
+  for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+    if (!busPing(MOTOR_IDS[i])) {
+      DEBUG_SERIAL.print("Baud negotiation: no answer from ID ");
+      DEBUG_SERIAL.println(MOTOR_IDS[i]);
+      all_ok = false;
+    }
+  }
+
+  if (all_ok) {
+    DEBUG_SERIAL.print("Dynamixel bus at ");
+    DEBUG_SERIAL.print((uint32_t)DXL_TARGET_BAUD_RATE);
+    DEBUG_SERIAL.println(" bps");
+    return DXL_TARGET_BAUD_RATE;
+  }
+
+  // Fall back - return every motor that made it to the target rate
+  for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+    if (busPing(MOTOR_IDS[i])) {
+      writeRegister(MOTOR_IDS[i], ADDR_TORQUE_ENABLE, 0, 1);
+      uint32_t start_us = micros();
+      bool ok = dxl.setBaudrate(MOTOR_IDS[i], DXL_BAUD_RATE);
+      recordBusTransfer(BUS_WRITE, start_us, 13, ok ? 11 : 0, ok);
+    }
+  }
+  dxl.begin(DXL_BAUD_RATE);
+
+  DEBUG_SERIAL.print("Dynamixel bus at ");
+  DEBUG_SERIAL.print((uint32_t)DXL_BAUD_RATE);
+  DEBUG_SERIAL.println(" bps (fallback)");
+  return DXL_BAUD_RATE;
+}
+
 /**
  * @brief Home all motors to their starting positions
  */
@@ -148,315 +388,1363 @@ void HardwareControl::homeAllAxes() {
 
   // First: Home restacker, cartridges and platform
   DEBUG_SERIAL.println("Homing restacker and cartridges...");
-  dxl.setGoalPosition(DXL_RESTACKER, RESTACKER_HOME);
-  dxl.setGoalPosition(DXL_CARTRIDGE1, CARTRIDGE1_HOME);
-  dxl.setGoalPosition(DXL_CARTRIDGE2, CARTRIDGE2_HOME);
-  dxl.setGoalPosition(DXL_CARTRIDGE3, CARTRIDGE3_HOME);
-  dxl.setGoalPosition(DXL_PLATFORM, (uint32_t)PLATFORM_HOME);
-
-  // Initialize extended position tracking variables to home position
-  cumulative_platform_degrees = (PLATFORM_HOME / 4096.0f) * 360.0f;
-  last_platform_degrees = cumulative_platform_degrees;
+  const uint8_t base_ids[] = {DXL_RESTACKER, DXL_CARTRIDGE1, DXL_CARTRIDGE2, DXL_CARTRIDGE3, DXL_PLATFORM};
+  // Platform: pick up its multi-turn count and go home the short way round
+  syncPlatformTicks();
+  rebasePlatformTurns();
+  // Handler and lifts: pick up their turn count so the HOME goals are the same positions
+  syncTravelTurns();
+  const int32_t base_goals[] = {(int32_t)RESTACKER_HOME, (int32_t)CARTRIDGE1_HOME, (int32_t)CARTRIDGE2_HOME,
+                                (int32_t)CARTRIDGE3_HOME, extendedPlatformTicks(PLATFORM_HOME_TICKS)};
+  setGoalPositions(base_ids, base_goals, 5);
 
   // Wait for completion
   waitForMotors();
 
   // Then: Home main motion system
   DEBUG_SERIAL.println("Homing main motion system...");
-  dxl.setGoalPosition(DXL_LID_LIFTER, (uint32_t)LID_LIFTER_HOME);
+  writeGoalPosition(DXL_LID_LIFTER, (uint32_t)LID_LIFTER_HOME);
   waitForMotors(DXL_LID_LIFTER);
-  dxl.setGoalPosition(DXL_POLAR_ARM, (uint32_t)POLAR_ARM_TO_VIAL);
-  dxl.setGoalPosition(DXL_HANDLER, (uint32_t)HANDLER_HOME);
+  const uint8_t main_ids[] = {DXL_POLAR_ARM, DXL_HANDLER};
+  const int32_t main_goals[] = {(int32_t)POLAR_ARM_TO_VIAL, (int32_t)HANDLER_HOME};
+  setGoalPositions(main_ids, main_goals, 2);
 
   // Wait for all motors to reach position
   waitForMotors();
 
   // Reset current positions
-  current_polar_angle = 0.0f;
-  current_platform_angle = 0.0f;
+  current_polar_angle = 0;
+  current_platform_angle = 0;
   first_move = true;
 
   DEBUG_SERIAL.println("All axes homed");
 }
 
 /**
- * @brief Wait for motors to complete their movement
+ * @brief Map the MotorTelemetry items into the motor's indirect address block
+ *
+ * Indirect addresses can only be written with torque off, so this is called
+ * from configureMotor() between its torque-off and torque-on writes.
  */
-void HardwareControl::waitForMotors(uint8_t motorId) {
-  uint32_t m1, m2, m3, m4, m5, m6, m7, m8;
-
-  // Initial delay to allow motor controller to update status registers
-  delay(50);
+bool HardwareControl::mapTelemetryBlock(uint8_t motorId) {
+  // One indirect entry per byte, in MotorTelemetry field order
+  const uint16_t fields[][2] = {
+    {ADDR_PRESENT_POSITION, 4},
+    {ADDR_PRESENT_VELOCITY, 4},
+    {ADDR_PRESENT_CURRENT, 2},
+    {ADDR_PRESENT_TEMPERATURE, 1},
+    {ADDR_MOVING, 1},
+    {ADDR_MOVING_STATUS, 1},
+    {ADDR_HARDWARE_ERROR, 1},
+  };
+  uint8_t table[sizeof(MotorTelemetry) * 2];
+  uint8_t entry = 0;
+
+  for (uint8_t f = 0; f < sizeof(fields) / sizeof(fields[0]); f++) {
+    for (uint16_t b = 0; b < fields[f][1]; b++) {
+      uint16_t addr = fields[f][0] + b;
+      table[entry * 2] = addr & 0xFF;
+      table[entry * 2 + 1] = addr >> 8;
+      entry++;
+    }
+  }
 
-  // Initial check to see if motors are moving
-  if (motorId > 0) {
-    m1 = dxl.readControlTableItem(ControlTableItem::MOVING, motorId);
-    m2 = m3 = m4 = m5 = m6 = m7 = m8 = 0;
+  // Same rule as writeRegister(): below level 2 no status packet comes back,
+  // so the block goes out as a single-ID Sync Write instead of a WRITE
+  bool ok;
+  if (status_return_level < 2) {
+    int8_t handle = scheduler.submitSyncWriteBlock(BUS_CLASS_GOAL, ADDR_INDIRECT_ADDRESS_1, sizeof(table), &motorId,
+                                                   table, 1, micros() + BUS_GOAL_DEADLINE_US);
+    ok = scheduler.wait(handle);
   } else {
-    // Check all 8 motors
-    m1 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_LID_LIFTER);
-    m2 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_POLAR_ARM);
-    m3 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_PLATFORM);
-    m4 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_HANDLER);
-    m5 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_RESTACKER);
-    m6 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE1);
-    m7 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE2);
-    m8 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE3);
+    busIdle();
+    uint32_t start_us = micros();
+    ok = dxl.write(motorId, ADDR_INDIRECT_ADDRESS_1, table, sizeof(table));
+    recordBusTransfer(BUS_WRITE, start_us, 12 + sizeof(table), ok ? 11 : 0, ok);
+  }
+  if (!ok) {
+    DEBUG_SERIAL.print("Telemetry mapping failed for ID ");
+    DEBUG_SERIAL.println(motorId);
+    return false;
   }
+  return true;
+}
 
-  // If no motors appear to be moving initially, wait a bit more and check again
-  if (m1 == 0 && m2 == 0 && m3 == 0 && m4 == 0 && m5 == 0 && m6 == 0 && m7 == 0 && m8 == 0) {
-    delay(50);
+/**
+ * @brief Read position, velocity, current, temperature, moving and error state
+ *        of every motor with one Sync Read
+ * @return true if all motors answered
+ */
+bool HardwareControl::readTelemetry() {
+  // Blocking wrapper - queue as an interlock read and wait for it
+  int8_t handle = scheduler.submitSyncRead(BUS_CLASS_INTERLOCK, ADDR_INDIRECT_DATA_1, sizeof(MotorTelemetry),
+                                           MOTOR_IDS, DXL_MOTOR_COUNT, micros() + BUS_INTERLOCK_DEADLINE_US,
+                                           &HardwareControl::onTelemetrySnapshot, this);
+  if (handle < 0) {
+    return false;
+  }
+  scheduler.wait(handle);
+  return telemetry.received == DXL_MOTOR_COUNT;
+}
 
-    // Double-check
-    if (motorId > 0) {
-      m1 = dxl.readControlTableItem(ControlTableItem::MOVING, motorId);
-    } else {
-      m1 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_LID_LIFTER);
-      m2 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_POLAR_ARM);
-      m3 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_PLATFORM);
-      m4 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_HANDLER);
-      m5 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_RESTACKER);
-      m6 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE1);
-      m7 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE2);
-      m8 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE3);
+/**
+ * @brief Copy the status packets of a finished telemetry read into the snapshot
+ * @return Number of motors that answered
+ */
+uint8_t HardwareControl::applyTelemetryStatus(const DxlTransport& result) {
+  uint8_t received = 0;
+  for (uint8_t i = 0; i < result.getStatusCount(); i++) {
+    const DxlTransport::Status* status = result.getStatus(i);
+    int8_t idx = motorIndex(status->id);
+    // A hardware alert still carries valid data - only instruction errors are dropped
+    if (idx >= 0 && (status->error & ~DXL_ERR_HARDWARE_ALERT) == 0 && status->length == sizeof(MotorTelemetry)) {
+      memcpy(&telemetry.motor[idx], status->data, sizeof(MotorTelemetry));
+      telemetry.motor[idx].position -= axis_turn_offset[idx];
+      received++;
+      if (telemetry.motor[idx].hardware_error != 0) {
+        fault_pending |= (1 << idx);
+      }
     }
+  }
+  return received;
+}
 
-    // If still no movement detected, assume completed quickly
-    if (m1 == 0 && m2 == 0 && m3 == 0 && m4 == 0 && m5 == 0 && m6 == 0 && m7 == 0 && m8 == 0) {
+/**
+ * @brief Scheduler callback for the blocking full telemetry read
+ */
+void HardwareControl::onTelemetrySnapshot(void* ctx, const DxlTransport& result, bool ok) {
+  HardwareControl* self = static_cast<HardwareControl*>(ctx);
+  self->telemetry.received = self->applyTelemetryStatus(result);
+  self->telemetry.timestamp_ms = millis();
+}
+
+/**
+ * @brief Step the background telemetry sweep without blocking
+ *
+ * The sweep reads a few motors per Sync Read so a whole response fits in the
+ * core's UART RX ring between two loop() iterations. The reads are queued at
+ * telemetry priority, so goal writes and interlock reads always go first.
+ */
+void HardwareControl::pollTelemetrySweep() {
+  scheduler.service();
+  if (telemetry_in_flight) {
+    return;
+  }
+
+  if (telemetry_next == 0) {
+    if (axis_state_valid && (millis() - axis_state_ms) < AXIS_STATE_REFRESH_MS) {
       return;
     }
+    telemetry_sweep_received = 0;
+    telemetry_sweep_ms = millis();
   }
 
-  // Main waiting loop
-  do {
-    if (motorId > 0) {
-      m1 = dxl.readControlTableItem(ControlTableItem::MOVING, motorId);
-      m2 = m3 = m4 = m5 = m6 = m7 = m8 = 0;
-    } else {
-      m1 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_LID_LIFTER);
-      m2 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_POLAR_ARM);
-      m3 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_PLATFORM);
-      m4 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_HANDLER);
-      m5 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_RESTACKER);
-      m6 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE1);
-      m7 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE2);
-      m8 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE3);
-    }
-    delay(5);
-  } while (m1 == 1 || m2 == 1 || m3 == 1 || m4 == 1 || m5 == 1 || m6 == 1 || m7 == 1 || m8 == 1);
+  uint8_t count = min(TELEMETRY_PER_READ, (uint8_t)(DXL_MOTOR_COUNT - telemetry_next));
+  telemetry_in_flight = true;
+  if (scheduler.submitSyncRead(BUS_CLASS_TELEMETRY, ADDR_INDIRECT_DATA_1, sizeof(MotorTelemetry),
+                               &MOTOR_IDS[telemetry_next], count, micros() + AXIS_STATE_REFRESH_MS * 1000UL,
+                               &HardwareControl::onTelemetrySweep, this, true) < 0) {
+    telemetry_in_flight = false;
+  }
 }
 
-
 /**
- * @brief Wait for motors to complete their movement
+ * @brief Scheduler callback - fold one finished background read into the sweep
  */
-void HardwareControl::waitForMotorsMin(uint8_t motorId) {
-  uint32_t m1, m2, m3, m4, m5, m6, m7, m8;
-
-  // Initial delay to allow motor controller to update status registers
-  delay(10);
+void HardwareControl::onTelemetrySweep(void* ctx, const DxlTransport& result, bool ok) {
+  HardwareControl* self = static_cast<HardwareControl*>(ctx);
+  self->telemetry_in_flight = false;
+  self->telemetry_sweep_received += self->applyTelemetryStatus(result);
+  self->telemetry_next += TELEMETRY_PER_READ;
+
+  if (self->telemetry_next < DXL_MOTOR_COUNT) {
+    return;
+  }
+  self->telemetry_next = 0;
 
-  // Initial check to see if motors are moving
-  if (motorId > 0) {
-    m1 = dxl.readControlTableItem(ControlTableItem::MOVING, motorId);
-    m2 = m3 = m4 = m5 = m6 = m7 = m8 = 0;
-  } else {
-    // Check all 8 motors
-    m1 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_LID_LIFTER);
-    m2 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_POLAR_ARM);
-    m3 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_PLATFORM);
-    m4 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_HANDLER);
-    m5 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_RESTACKER);
-    m6 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE1);
-    m7 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE2);
-    m8 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE3);
+  // A blocking read may have produced a newer snapshot in the meantime
+  if ((int32_t)(self->telemetry_sweep_ms - self->telemetry.timestamp_ms) < 0) {
+    return;
   }
+  self->telemetry.received = self->telemetry_sweep_received;
+  self->telemetry.timestamp_ms = self->telemetry_sweep_ms;
+  if (self->telemetry.received == DXL_MOTOR_COUNT) {
+    self->loadAxisState();
+  }
+}
 
-  // If no motors appear to be moving initially, wait a bit more and check again
-  if (m1 == 0 && m2 == 0 && m3 == 0 && m4 == 0 && m5 == 0 && m6 == 0 && m7 == 0 && m8 == 0) {
-    delay(10);
+/**
+ * @brief Scheduler observer - account every transaction in the bus statistics
+ */
+void HardwareControl::onBusTransaction(void* ctx, uint8_t instruction, const DxlTransport& result) {
+  HardwareControl* self = static_cast<HardwareControl*>(ctx);
+  uint8_t lib_error = (result.getState() == DxlTransport::DONE) ? (uint8_t)DXL_LIB_OK : result.lastError();
+  BusInstruction type = (instruction == INST_SYNC_WRITE) ? BUS_SYNC_WRITE : BUS_SYNC_READ;
+  self->accountBusTransfer(type, result.getStartMicros(), result.getTxBytes(), result.getRxBytes(), lib_error);
+}
 
-    // Double-check
-    if (motorId > 0) {
-      m1 = dxl.readControlTableItem(ControlTableItem::MOVING, motorId);
-    } else {
-      m1 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_LID_LIFTER);
-      m2 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_POLAR_ARM);
-      m3 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_PLATFORM);
-      m4 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_HANDLER);
-      m5 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_RESTACKER);
-      m6 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE1);
-      m7 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE2);
-      m8 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE3);
+/**
+ * @brief Scheduler callback for the MOVING / MOVING_STATUS poll
+ */
+void HardwareControl::onMovingRead(void* ctx, const DxlTransport& result, bool ok) {
+  HardwareControl* self = static_cast<HardwareControl*>(ctx);
+  self->moving_received = 0;
+  for (uint8_t i = 0; i < result.getStatusCount(); i++) {
+    const DxlTransport::Status* status = result.getStatus(i);
+    int8_t idx = motorIndex(status->id);
+    if (idx >= 0 && status->length == sizeof(MovingSyncData)) {
+      memcpy(&self->moving_sync_data[idx], status->data, sizeof(MovingSyncData));
+      self->moving_received++;
     }
-
-    // If still no movement detected, assume completed quickly
-    if (m1 == 0 && m2 == 0 && m3 == 0 && m4 == 0 && m5 == 0 && m6 == 0 && m7 == 0 && m8 == 0) {
-      return;
+    if (idx >= 0 && (status->error & DXL_ERR_HARDWARE_ALERT)) {
+      self->fault_pending |= (1 << idx);
     }
   }
+}
 
-  // Main waiting loop
-  do {
-    if (motorId > 0) {
-      m1 = dxl.readControlTableItem(ControlTableItem::MOVING, motorId);
-      m2 = m3 = m4 = m5 = m6 = m7 = m8 = 0;
+/**
+ * @brief Let background bus traffic run for a while
+ *
+ * Used instead of delay() while waiting on motion. The end of the wait is
+ * reserved, so no telemetry read is still on the bus when the caller polls
+ * or sends the next goal.
+ */
+void HardwareControl::serviceBus(uint32_t ms) {
+  uint32_t start_ms = millis();
+  scheduler.reserve(micros() + ms * 1000UL);
+  while (millis() - start_ms < ms) {
+    if (is_initialized) {
+      pollTelemetrySweep();
     } else {
-      m1 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_LID_LIFTER);
-      m2 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_POLAR_ARM);
-      m3 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_PLATFORM);
-      m4 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_HANDLER);
-      m5 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_RESTACKER);
-      m6 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE1);
-      m7 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE2);
-      m8 = dxl.readControlTableItem(ControlTableItem::MOVING, DXL_CARTRIDGE3);
+      scheduler.service();
     }
-    delay(1);
-  } while (m1 == 1 || m2 == 1 || m3 == 1 || m4 == 1 || m5 == 1 || m6 == 1 || m7 == 1 || m8 == 1);
+  }
 }
-// ============================================================================
-// SEMANTIC WRAPPER FUNCTIONS (MATCH NUK COMMANDS)
-// ============================================================================
 
 /**
- * @brief Move handler to work area (streaking station)
- * MOVE WORK_AREA command implementation
+ * @brief Finish the running scheduled transaction before a blocking Dynamixel2Arduino call
  */
-bool HardwareControl::moveToWorkArea() {
-  DEBUG_SERIAL.println("Moving to work area (streaking station)");
-  return rotateToStreakingStation();
+void HardwareControl::busIdle() {
+  scheduler.idle();
+}
+
+const TelemetrySnapshot& HardwareControl::getTelemetry() const {
+  return telemetry;
+}
+
+const MotorTelemetry* HardwareControl::getMotorTelemetry(uint8_t motorId) const {
+  int8_t idx = motorIndex(motorId);
+  return (idx < 0) ? nullptr : &telemetry.motor[idx];
 }
 
 /**
- * @brief Move handler to storage position (restacker)
- * MOVE STRG command implementation
+ * @brief Position of a motor ID in MOTOR_IDS (and every per-axis array)
+ * @return Index, or -1 for an unknown ID
  */
-bool HardwareControl::moveToStorage() {
-  DEBUG_SERIAL.println("Moving to storage position");
-  return rotateHandlerToFinished();
+int8_t HardwareControl::motorIndex(uint8_t motorId) {
+  for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+    if (MOTOR_IDS[i] == motorId) {
+      return i;
+    }
+  }
+  return -1;
 }
 
 /**
- * @brief Move handler to normal cartridge position
- * MOVE NORMAL command implementation
+ * @brief Refresh the axis state table from one telemetry Sync Read
+ * @return true if every motor answered
  */
-bool HardwareControl::moveToNormal() {
-  DEBUG_SERIAL.println("Moving to normal cartridge position");
-  return rotateHandlerToC1();
+bool HardwareControl::refreshAxisState() {
+  if (!readTelemetry()) {
+    return false;
+  }
+  loadAxisState();
+  return true;
 }
 
 /**
- * @brief Move handler to blood cartridge position
- * MOVE BLOOD command implementation
+ * @brief Copy a complete telemetry snapshot into the axis state table
  */
-bool HardwareControl::moveToBlood() {
-  DEBUG_SERIAL.println("Moving to blood cartridge position");
-  return rotateHandlerToC2();
+void HardwareControl::loadAxisState() {
+  for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+    axis_position[i] = telemetry.motor[i].position;
+    axis_moving[i] = telemetry.motor[i].moving;
+    axis_load[i] = telemetry.motor[i].current;
+  }
+  axis_state_ms = telemetry.timestamp_ms;
+  axis_state_valid = true;
 }
 
 /**
- * @brief Move handler to chocolat cartridge position
- * MOVE CHOCOLAT command implementation
+ * @brief true if the axis state table is younger than AXIS_STATE_MAX_AGE_MS
  */
-bool HardwareControl::moveToChocolat() {
-  DEBUG_SERIAL.println("Moving to chocolat cartridge position");
-  return rotateHandlerToC3();
+bool HardwareControl::axisStateFresh() const {
+  return axis_state_valid && (millis() - axis_state_ms) <= AXIS_STATE_MAX_AGE_MS;
+}
+
+/**
+ * @brief Periodic housekeeping - refresh the axis state table in the background
+ *
+ * Never waits on the bus: each call advances the non-blocking telemetry sweep
+ * by at most one step.
+ */
+void HardwareControl::update() {
+  if (!is_initialized) {
+    return;
+  }
+  pollTelemetrySweep();
+  recoverFaults();
 }
 
 // ============================================================================
-// LIFT SEMANTIC WRAPPER FUNCTIONS
+// FAULT RECOVERY
 // ============================================================================
 
 /**
- * @brief Lift storage (restacker) up
- * LIFT STRG Top command implementation
+ * @brief Recover every motor that reported a hardware error
+ * @return true if at least one motor was recovered (its goal was re-sent)
  */
-bool HardwareControl::liftStorageTop() {
-  DEBUG_SERIAL.println("Lifting storage top");
-  return moveRestackerTop();
+bool HardwareControl::recoverFaults() {
+  if (fault_pending == 0 || in_recovery) {
+    return false;
+  }
+
+  bool recovered = false;
+  for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+    if (fault_pending & (1 << i)) {
+      fault_pending &= ~(1 << i);
+      recovered |= recoverMotor(MOTOR_IDS[i]);
+    }
+  }
+  return recovered;
 }
 
 /**
- * @brief Lift storage (restacker) up
- * LIFT STRG UP command implementation
+ * @brief Reboot one faulted motor and put it back where it was
+ *
+ * Clears the hardware error with a Reboot instruction, re-learns the turn
+ * count extended position axes lose on reboot (restoreTurnCount()),
+ * re-applies the motor's setup and re-sends its last goal. The event is
+ * reported to the host as "FAULT <id> HWERR <bits> RECOVERED|FAILED <ms>".
  */
-bool HardwareControl::liftStorageUp() {
-  DEBUG_SERIAL.println("Lifting storage up");
-  return moveRestackerUp();
+bool HardwareControl::recoverMotor(uint8_t motorId) {
+  int8_t idx = motorIndex(motorId);
+  if (idx < 0) {
+    return false;
+  }
+  in_recovery = true;
+  uint32_t start_ms = millis();
+
+  // What tripped, and where the axis was
+  int32_t hardware_error = telemetry.motor[idx].hardware_error;
+  busRead(motorId, ADDR_HARDWARE_ERROR, 1, hardware_error);
+  int32_t last_position = axis_position[idx];
+  if (!axisStateFresh() && busRead(motorId, ADDR_PRESENT_POSITION, 4, last_position)) {
+    last_position -= axis_turn_offset[idx];
+  }
+
+  // Reboot - with Status Return Level 1 there is no reply, so wait for a ping
+  busIdle();
+  uint32_t start_us = micros();
+  dxl.reboot(motorId);
+  recordBusTransfer(BUS_WRITE, start_us, 10, 0, true);
+
+  bool alive = false;
+  while (!alive && millis() - start_ms < FAULT_REBOOT_TIMEOUT_MS) {
+    delay(FAULT_PING_INTERVAL_MS);
+    alive = busPing(motorId);
+  }
+
+  // RAM items are back to factory values; re-learn everything on the next write
+  shadow[idx].valid = 0;
+  axis_state_valid = false;
+
+  if (alive) {
+    writeRegister(motorId, ADDR_STATUS_RETURN_LEVEL, status_return_level, 1);
+    if (MOTOR_SETUP[idx].mode == OP_EXTENDED_POSITION) {
+      restoreTurnCount(motorId, last_position);
+    }
+    configureMotor(motorId);
+    writeGoalPosition(motorId, axis_goal[idx]);
+  }
+
+  DEBUG_SERIAL.print("FAULT ");
+  DEBUG_SERIAL.print(motorId);
+  DEBUG_SERIAL.print(" HWERR 0x");
+  DEBUG_SERIAL.print(hardware_error, HEX);
+  DEBUG_SERIAL.print(alive ? " RECOVERED " : " FAILED ");
+  DEBUG_SERIAL.println(millis() - start_ms);
+
+  in_recovery = false;
+  return alive;
 }
 
 /**
- * @brief Lift storage (restacker) mid
- * LIFT STRG MID command implementation
+ * @brief Re-learn the whole turns an extended position axis lost on reboot
+ *
+ * After a reboot the motor counts from its single-turn angle again. The
+ * difference to the pre-reboot position is kept as the axis turn offset in
+ * RAM - Homing Offset is an EEPROM item and would still be applied after the
+ * next power cycle.
  */
-bool HardwareControl::liftStorageMid() {
-  DEBUG_SERIAL.println("Lifting storage mid");
-  return moveRestackerMid();
+void HardwareControl::restoreTurnCount(uint8_t motorId, int32_t last_position) {
+  int8_t idx = motorIndex(motorId);
+  int32_t present = 0;
+  if (idx < 0 || !busRead(motorId, ADDR_PRESENT_POSITION, 4, present)) {
+    return;
+  }
+
+  // Nearest whole number of turns between where it is and where it was
+  axis_turn_offset[idx] = nearestTurns(present - last_position) * DXL_TICKS_PER_TURN;
 }
 
 /**
- * @brief Lift storage (restacker) down
- * LIFT STRG DOWN command implementation
+ * @brief Continue the platform's multi-turn goals from where it is now
+ *
+ * Goals are never re-zeroed - spirals leave the platform whole turns further
+ * on, and later goals carry on from there (extendedPlatformTicks()).
  */
-bool HardwareControl::liftStorageDown() {
-  DEBUG_SERIAL.println("Lifting storage down");
-  return moveRestackerDown();
+void HardwareControl::syncPlatformTicks() {
+  int32_t present = 0;
+  if (!busRead(DXL_PLATFORM, ADDR_PRESENT_POSITION, 4, present)) {
+    return;
+  }
+  present -= axis_turn_offset[motorIndex(DXL_PLATFORM)];
+  cumulative_platform_ticks = present;
+  last_platform_ticks = present & (DXL_TICKS_PER_TURN - 1);
 }
 
 /**
- * @brief Lift normal cartridge top
- * LIFT NORMAL UP command implementation
+ * @brief Pick up the turn count of the handler and lifts from where they are
+ *
+ * Their goals are fixed positions on one extended scale (HANDLER_RESTACKER is
+ * past one turn), but after a power cycle the motors count from their
+ * single-turn angle. Like the platform (syncPlatformTicks()), the turns are
+ * kept in software: each axis gets the turn offset that puts it nearest the
+ * middle of its travel.
  */
-bool HardwareControl::liftNormalTop() {
-  DEBUG_SERIAL.println("Lifting normal cartridge top");
-  return moveCartridgeTop(1);
+void HardwareControl::syncTravelTurns() {
+  for (uint8_t i = 0; i < 5; i++) {
+    int8_t idx = motorIndex(TRAVEL_AXIS_IDS[i]);
+    int32_t present = 0;
+    if (idx < 0 || !busRead(TRAVEL_AXIS_IDS[i], ADDR_PRESENT_POSITION, 4, present)) {
+      continue;
+    }
+    int32_t offset = nearestTurns(present - TRAVEL_MIDDLE[i]) * DXL_TICKS_PER_TURN;
+    if (offset != axis_turn_offset[idx]) {
+      // The motor's goal register is on the old scale
+      axis_turn_offset[idx] = offset;
+      shadowForget(TRAVEL_AXIS_IDS[i], ADDR_GOAL_POSITION);
+      axis_state_valid = false;
+    }
+  }
 }
 
 /**
- * @brief Lift normal cartridge up
- * LIFT NORMAL UP command implementation
+ * @brief Fold the platform's accumulated turns into its Homing Offset
+ *
+ * Only once they pass PLATFORM_MAX_TURNS, so the extended position range is
+ * never reached. Writing the offset needs torque off, which is why this is
+ * left to homing rather than done after every spiral.
  */
-bool HardwareControl::liftNormalUp() {
-  DEBUG_SERIAL.println("Lifting normal cartridge up");
-  return moveCartridgeUp(1);
+void HardwareControl::rebasePlatformTurns() {
+  int32_t turns = nearestTurns(cumulative_platform_ticks - PLATFORM_HOME_TICKS);
+  if (abs(turns) <= PLATFORM_MAX_TURNS) {
+    return;
+  }
+  int32_t offset = 0;
+  if (!busRead(DXL_PLATFORM, ADDR_HOMING_OFFSET, 4, offset)) {
+    return;
+  }
+  writeRegister(DXL_PLATFORM, ADDR_TORQUE_ENABLE, 0, 1);
+  writeRegister(DXL_PLATFORM, ADDR_HOMING_OFFSET, offset - turns * DXL_TICKS_PER_TURN, 4);
+  writeRegister(DXL_PLATFORM, ADDR_TORQUE_ENABLE, 1, 1);
+  cumulative_platform_ticks -= turns * DXL_TICKS_PER_TURN;
+  writeGoalPosition(DXL_PLATFORM, cumulative_platform_ticks);
 }
 
+// ============================================================================
+// BUS INSTRUMENTATION
+// ============================================================================
+
 /**
- * @brief Lift normal cartridge mid
- * LIFT NORMAL UP command implementation
+ * @brief Account one Dynamixel transfer in the bus statistics
+ * @param type Instruction class
+ * @param start_us micros() taken just before the library call
+ * @param tx_bytes Instruction packet size (10 bytes of framing + parameters)
+ * @param rx_bytes Status bytes received (11 bytes of framing + data per status)
+ * @param ok false if the library reported a failure
  */
-bool HardwareControl::liftNormalMid() {
-  DEBUG_SERIAL.println("Lifting normal cartridge mid");
-  return moveCartridgeMid(1);
+void HardwareControl::recordBusTransfer(BusInstruction type, uint32_t start_us, uint16_t tx_bytes, uint16_t rx_bytes, bool ok) {
+  accountBusTransfer(type, start_us, tx_bytes, rx_bytes, ok ? (uint8_t)DXL_LIB_OK : dxl.getLastLibErrCode());
 }
 
 /**
- * @brief Lift normal cartridge down
- * LIFT NORMAL DOWN command implementation
+ * @brief Account one transfer with an explicit DXLLibErrorCode result
+ *
+ * Used directly for transport transactions, whose time is bus occupancy
+ * rather than time the CPU spent blocked.
  */
-bool HardwareControl::liftNormalDown() {
-  DEBUG_SERIAL.println("Lifting normal cartridge down");
-  return moveCartridgeDown(1);
+void HardwareControl::accountBusTransfer(BusInstruction type, uint32_t start_us, uint16_t tx_bytes, uint16_t rx_bytes, uint8_t lib_error) {
+  static const uint32_t bounds_us[BUS_LATENCY_BUCKETS - 1] = BUS_LATENCY_BOUNDS_US;
+  uint32_t elapsed_us = micros() - start_us;
+  BusInstructionStats& stats = bus_stats.instruction[type];
+
+  stats.packets++;
+  stats.tx_bytes += tx_bytes;
+  stats.rx_bytes += rx_bytes;
+  stats.busy_us += elapsed_us;
+  stats.max_us = max(stats.max_us, elapsed_us);
+
+  uint8_t bucket = 0;
+  while (bucket < BUS_LATENCY_BUCKETS - 1 && elapsed_us >= bounds_us[bucket]) {
+    bucket++;
+  }
+  stats.latency[bucket]++;
+
+  if (lib_error != DXL_LIB_OK) {
+    switch (lib_error) {
+      case DXL_LIB_ERROR_TIMEOUT: stats.timeouts++; break;
+      case DXL_LIB_ERROR_CRC:     stats.crc_errors++; break;
+      default:                    stats.other_errors++; break;
+    }
+  }
 }
 
 /**
- * @brief Lift blood cartridge top
- * LIFT NORMAL UP command implementation
+ * @brief Ping one motor, counted as a read
  */
-bool HardwareControl::liftBloodTop() {
-  DEBUG_SERIAL.println("Lifting blood cartridge top");
-  return moveCartridgeTop(2);
+bool HardwareControl::busPing(uint8_t motorId) {
+  busIdle();
+  uint32_t start_us = micros();
+  bool ok = dxl.ping(motorId);
+  recordBusTransfer(BUS_READ, start_us, 10, ok ? 14 : 0, ok);
+  return ok;
 }
 
 /**
- * @brief Lift blood cartridge up
- * LIFT BLOOD UP command implementation
+ * @brief Read one control-table item of one motor
+ * @param value Sign-extended register value (untouched on failure)
+ * @return true if the motor answered
  */
-bool HardwareControl::liftBloodUp() {
-  DEBUG_SERIAL.println("Lifting blood cartridge up");
-  return moveCartridgeUp(2);
-}
+bool HardwareControl::busRead(uint8_t motorId, uint16_t addr, uint8_t len, int32_t& value) {
+  uint8_t buf[sizeof(int32_t)] = {0, 0, 0, 0};
+  busIdle();
+  uint32_t start_us = micros();
+  bool ok = dxl.read(motorId, addr, len, buf, sizeof(buf)) == len;
+  recordBusTransfer(BUS_READ, start_us, 14, ok ? 11 + len : 0, ok);
+  if (!ok) {
+    return false;
+  }
+
+  int8_t idx = motorIndex(motorId);
+  if (idx >= 0 && (dxl.getLastStatusPacketError() & DXL_ERR_HARDWARE_ALERT)) {
+    fault_pending |= (1 << idx);
+  }
+
+  // Little-endian register; 1-byte items are unsigned, wider ones signed
+  switch (len) {
+    case 1:  value = buf[0]; break;
+    case 2:  value = (int16_t)(buf[0] | (buf[1] << 8)); break;
+    default: memcpy(&value, buf, sizeof(int32_t)); break;
+  }
+  return true;
+}
+
+/**
+ * @brief Present Position of one motor (0 if it did not answer)
+ */
+int32_t HardwareControl::readPresentPosition(uint8_t motorId) {
+  int32_t position = 0;
+  int8_t idx = motorIndex(motorId);
+  if (busRead(motorId, ADDR_PRESENT_POSITION, 4, position) && idx >= 0) {
+    position -= axis_turn_offset[idx];
+  }
+  return position;
+}
+
+/**
+ * @brief Moving flag of one motor (false if it did not answer)
+ */
+bool HardwareControl::readMoving(uint8_t motorId) {
+  int32_t moving = 0;
+  busRead(motorId, ADDR_MOVING, 1, moving);
+  return moving != 0;
+}
+
+/**
+ * @brief Value as it goes on the bus - goal positions get the axis turn offset added
+ */
+int32_t HardwareControl::busGoal(uint8_t motorId, uint16_t addr, int32_t value) const {
+  int8_t idx = motorIndex(motorId);
+  return (addr == ADDR_GOAL_POSITION && idx >= 0) ? value + axis_turn_offset[idx] : value;
+}
+
+const BusStats& HardwareControl::getBusStats() const {
+  return bus_stats;
+}
+
+const BusClassStats& HardwareControl::getBusClassStats(BusClass bus_class) const {
+  return scheduler.getStats(bus_class);
+}
+
+void HardwareControl::resetBusStats() {
+  scheduler.resetStats();
+  memset(&bus_stats, 0, sizeof(bus_stats));
+  bus_stats.since_ms = millis();
+}
+
+// ============================================================================
+// CONTROL-TABLE SHADOW
+// ============================================================================
+
+/**
+ * @brief Shadow storage for one control-table item of one motor
+ * @param bit Set to the item's valid bit
+ * @return Slot pointer, or nullptr if the address is not shadowed
+ */
+int32_t* HardwareControl::shadowSlot(uint8_t motorId, uint16_t addr, uint8_t& bit) {
+  int8_t idx = motorIndex(motorId);
+  if (idx < 0) {
+    return nullptr;
+  }
+
+  ShadowItem item;
+  switch (addr) {
+    case ADDR_RETURN_DELAY_TIME:    item = SHADOW_RETURN_DELAY_TIME; break;
+    case ADDR_DRIVE_MODE:           item = SHADOW_DRIVE_MODE; break;
+    case ADDR_OPERATING_MODE:       item = SHADOW_OPERATING_MODE; break;
+    case ADDR_TORQUE_ENABLE:        item = SHADOW_TORQUE_ENABLE; break;
+    case ADDR_STATUS_RETURN_LEVEL:  item = SHADOW_STATUS_RETURN_LEVEL; break;
+    case ADDR_PROFILE_ACCELERATION: item = SHADOW_PROFILE_ACCELERATION; break;
+    case ADDR_PROFILE_VELOCITY:     item = SHADOW_PROFILE_VELOCITY; break;
+    case ADDR_GOAL_POSITION:        item = SHADOW_GOAL_POSITION; break;
+    default:
+      return nullptr;
+  }
+
+  bit = 1 << item;
+  return (item == SHADOW_GOAL_POSITION) ? &axis_goal[idx] : &shadow[idx].value[item];
+}
+
+/**
+ * @brief true if the motor is known to already hold this value
+ */
+bool HardwareControl::shadowMatches(uint8_t motorId, uint16_t addr, int32_t value) {
+  uint8_t bit;
+  int32_t* slot = shadowSlot(motorId, addr, bit);
+  return slot != nullptr && (shadow[motorIndex(motorId)].valid & bit) && *slot == value;
+}
+
+/**
+ * @brief Record a value that was just written
+ */
+void HardwareControl::shadowStore(uint8_t motorId, uint16_t addr, int32_t value) {
+  uint8_t bit;
+  int32_t* slot = shadowSlot(motorId, addr, bit);
+  if (slot == nullptr) {
+    return;
+  }
+  *slot = value;
+  shadow[motorIndex(motorId)].valid |= bit;
+
+  // Torque and mode changes make the motor reload Goal Position from Present Position
+  if (addr == ADDR_TORQUE_ENABLE || addr == ADDR_OPERATING_MODE) {
+    shadowForget(motorId, ADDR_GOAL_POSITION);
+  }
+}
+
+/**
+ * @brief Mark an item unknown so the next write always goes out
+ */
+void HardwareControl::shadowForget(uint8_t motorId, uint16_t addr) {
+  uint8_t bit;
+  if (shadowSlot(motorId, addr, bit) != nullptr) {
+    shadow[motorIndex(motorId)].valid &= ~bit;
+  }
+}
+
+/**
+ * @brief Read the same address range from every motor with one Sync Read
+ * @param dest DXL_MOTOR_COUNT * len bytes, one block per motor in MOTOR_IDS order
+ * @return true if every motor answered
+ */
+bool HardwareControl::syncReadRange(uint16_t addr, uint16_t len, uint8_t* dest) {
+  uint8_t packet_buf[DXL_PACKET_BUF_SIZE];
+  DYNAMIXEL::InfoSyncReadInst_t info;
+  DYNAMIXEL::XELInfoSyncRead_t xels[DXL_MOTOR_COUNT];
+
+  info.packet.p_buf = packet_buf;
+  info.packet.buf_capacity = DXL_PACKET_BUF_SIZE;
+  info.packet.is_completed = false;
+  info.addr = addr;
+  info.addr_length = len;
+  info.p_xels = xels;
+  info.xel_count = DXL_MOTOR_COUNT;
+  for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+    xels[i].id = MOTOR_IDS[i];
+    xels[i].p_recv_buf = dest + i * len;
+  }
+  info.is_info_changed = true;
+
+  busIdle();
+  uint32_t start_us = micros();
+  int32_t received = dxl.syncRead(&info);
+  bool ok = (received == DXL_MOTOR_COUNT);
+  recordBusTransfer(BUS_SYNC_READ, start_us, 14 + DXL_MOTOR_COUNT, ok ? received * (11 + len) : 0, ok);
+  return ok;
+}
+
+/**
+ * @brief Seed the shadow from the motors with three Sync Reads
+ *
+ * EEPROM items (mode, return delay) survive power cycles, so after the first
+ * boot initialize() finds them already set and skips the writes.
+ */
+void HardwareControl::primeShadow() {
+  uint8_t eeprom[DXL_MOTOR_COUNT][3];   // Return Delay Time, Drive Mode, Operating Mode
+  uint8_t ram[DXL_MOTOR_COUNT][5];      // Torque Enable .. Status Return Level
+  uint8_t profile[DXL_MOTOR_COUNT][12]; // Profile Acceleration, Profile Velocity, Goal Position
+
+  if (syncReadRange(ADDR_RETURN_DELAY_TIME, 3, &eeprom[0][0])) {
+    for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+      shadowStore(MOTOR_IDS[i], ADDR_RETURN_DELAY_TIME, eeprom[i][0]);
+      shadowStore(MOTOR_IDS[i], ADDR_DRIVE_MODE, eeprom[i][1]);
+      shadowStore(MOTOR_IDS[i], ADDR_OPERATING_MODE, eeprom[i][2]);
+    }
+  }
+
+  if (syncReadRange(ADDR_TORQUE_ENABLE, 5, &ram[0][0])) {
+    uint8_t lowest_level = 2;
+    for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+      uint8_t level = ram[i][ADDR_STATUS_RETURN_LEVEL - ADDR_TORQUE_ENABLE];
+      shadowStore(MOTOR_IDS[i], ADDR_TORQUE_ENABLE, ram[i][0]);
+      shadowStore(MOTOR_IDS[i], ADDR_STATUS_RETURN_LEVEL, level);
+      lowest_level = min(lowest_level, level);
+    }
+    // A warm restart finds the motors still on the reduced level - don't wait for acks
+    status_return_level = lowest_level;
+  }
+
+  if (syncReadRange(ADDR_PROFILE_ACCELERATION, 12, &profile[0][0])) {
+    for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+      int32_t accel, velocity, goal;
+      memcpy(&accel, &profile[i][0], 4);
+      memcpy(&velocity, &profile[i][4], 4);
+      memcpy(&goal, &profile[i][8], 4);
+      goal -= axis_turn_offset[i];
+      shadowStore(MOTOR_IDS[i], ADDR_PROFILE_ACCELERATION, accel);
+      shadowStore(MOTOR_IDS[i], ADDR_PROFILE_VELOCITY, velocity);
+      shadowStore(MOTOR_IDS[i], ADDR_GOAL_POSITION, goal);
+    }
+  }
+}
+
+/**
+ * @brief Set the Status Return Level of every motor and remember it
+ *
+ * Sent as a Sync Write so the change itself never waits for a status packet.
+ */
+void HardwareControl::applyStatusReturnLevel(uint8_t level) {
+  int32_t values[DXL_MOTOR_COUNT];
+  for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+    values[i] = level;
+  }
+  syncWriteRegister(ADDR_STATUS_RETURN_LEVEL, 1, MOTOR_IDS, values, DXL_MOTOR_COUNT);
+  status_return_level = level;
+
+  DEBUG_SERIAL.print("Status Return Level ");
+  DEBUG_SERIAL.println(level);
+}
+
+/**
+ * @brief Write the same register on several motors with one Sync Write
+ * @param addr Control table address
+ * @param len Register size in bytes (1, 2 or 4)
+ * @param ids Motor IDs
+ * @param values One value per ID
+ * @param count Number of motors (at most DXL_MOTOR_COUNT)
+ * @return true if the packet was sent
+ */
+bool HardwareControl::syncWriteRegister(uint16_t addr, uint8_t len, const uint8_t* ids, const int32_t* values, uint8_t count) {
+  if (count == 0 || count > DXL_MOTOR_COUNT || len > sizeof(int32_t)) {
+    return false;
+  }
+
+  // Leave out motors whose shadow already holds the value
+  uint8_t sent_ids[DXL_MOTOR_COUNT];
+  int32_t sent_values[DXL_MOTOR_COUNT];
+  uint8_t sent = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    if (shadowMatches(ids[i], addr, values[i])) {
+      continue;
+    }
+    sent_ids[sent] = ids[i];
+    sent_values[sent] = values[i];
+    sent++;
+  }
+  if (sent == 0) {
+    return true;
+  }
+
+  // Writes go out at goal priority, ahead of any queued reads
+  int32_t bus_values[DXL_MOTOR_COUNT];
+  for (uint8_t i = 0; i < sent; i++) {
+    bus_values[i] = busGoal(sent_ids[i], addr, sent_values[i]);
+  }
+  int8_t handle = scheduler.submitSyncWrite(BUS_CLASS_GOAL, addr, len, sent_ids, bus_values, sent,
+                                            micros() + BUS_GOAL_DEADLINE_US);
+  if (!scheduler.wait(handle)) {
+    return false;
+  }
+  for (uint8_t i = 0; i < sent; i++) {
+    shadowStore(sent_ids[i], addr, sent_values[i]);
+  }
+  return true;
+}
+
+/**
+ * @brief Write one register, honouring the active Status Return Level
+ *
+ * With acknowledged writes this is a normal WRITE that waits for the status
+ * packet. Otherwise it goes out as a single-ID Sync Write, which never gets a
+ * reply, so the caller does not sit out a status timeout.
+ */
+bool HardwareControl::writeRegister(uint8_t motorId, uint16_t addr, int32_t value, uint8_t len) {
+  if (shadowMatches(motorId, addr, value)) {
+    return true;
+  }
+  if (status_return_level < 2) {
+    return syncWriteRegister(addr, len, &motorId, &value, 1);
+  }
+
+  busIdle();
+  uint32_t start_us = micros();
+  int32_t bus_value = busGoal(motorId, addr, value);
+  bool ok = dxl.write(motorId, addr, (const uint8_t*)&bus_value, len);
+  recordBusTransfer(BUS_WRITE, start_us, 12 + len, ok ? 11 : 0, ok);
+  if (ok) {
+    shadowStore(motorId, addr, value);
+    return true;
+  }
+  shadowForget(motorId, addr);
+  return false;
+}
+
+/**
+ * @brief Send a raw goal position to one motor
+ */
+bool HardwareControl::writeGoalPosition(uint8_t motorId, int32_t goal) {
+  if (profile_override) {
+    restoreProfiles(&motorId, 1);
+  }
+  return writeRegister(motorId, ADDR_GOAL_POSITION, goal, sizeof(int32_t));
+}
+
+/**
+ * @brief Start several axes toward their goals with a single Sync Write
+ * @param ids Motor IDs to command
+ * @param goals Raw goal positions, one per ID
+ * @param count Number of axes (at most DXL_MOTOR_COUNT)
+ * @return true if the goals were sent
+ */
+bool HardwareControl::setGoalPositions(const uint8_t* ids, const int32_t* goals, uint8_t count) {
+  if (profile_override) {
+    restoreProfiles(ids, count);
+  }
+  if (syncWriteRegister(ADDR_GOAL_POSITION, sizeof(int32_t), ids, goals, count)) {
+    return true;
+  }
+
+  // Sync Write could not be sent - fall back to individual goal writes
+  bus_stats.instruction[BUS_SYNC_WRITE].retries++;
+  bool success = true;
+  for (uint8_t i = 0; i < count; i++) {
+    success &= writeGoalPosition(ids[i], goals[i]);
+  }
+  return success;
+}
+
+// ============================================================================
+// MOTION GROUPS
+// ============================================================================
+
+/**
+ * @brief Send one goal and return the group to wait on
+ */
+MotionGroup HardwareControl::startMove(uint8_t motorId, int32_t goal) {
+  return startMoves(&motorId, &goal, 1);
+}
+
+/**
+ * @brief Send several goals together (one Sync Write) and return their group
+ */
+MotionGroup HardwareControl::startMoves(const uint8_t* ids, const int32_t* goals, uint8_t count) {
+  MotionGroup group;
+  if (!setGoalPositions(ids, goals, count)) {
+    return group;
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    int8_t idx = motorIndex(ids[i]);
+    if (idx >= 0) {
+      group.axes |= (1 << idx);
+      group.goal[idx] = goals[i];
+    }
+  }
+  group.started_ms = millis();
+  return group;
+}
+
+/**
+ * @brief Rotate the handler if the lift interlock allows it
+ * @return Handler group, or an empty group if the move was refused
+ */
+MotionGroup HardwareControl::startHandlerMove(float position) {
+  MotionGroup group;
+  if (!setHandlerGoalPosition(position)) {
+    return group;
+  }
+
+  int8_t idx = motorIndex(DXL_HANDLER);
+  group.axes = (1 << idx);
+  group.goal[idx] = (int32_t)position;
+  group.started_ms = millis();
+  return group;
+}
+
+/**
+ * @brief Start several axes so they all arrive at the same time
+ *
+ * The axis with the longest move runs at SEGMENT_VELOCITY/SEGMENT_ACCEL; the
+ * others get both scaled by their share of that distance. A trapezoid scaled
+ * that way takes the same time, so the axes start and stop together and the
+ * tool follows the straight joint-space line between the two points.
+ *
+ * Profile acceleration, velocity and goal are consecutive in the control
+ * table, so the whole segment is one Sync Write. The axes keep the segment
+ * profile until a normal move restores it (see restoreProfiles()).
+ */
+MotionGroup HardwareControl::startCoordinatedMove(const uint8_t* ids, const int32_t* goals, uint8_t count) {
+  MotionGroup group;
+  if (count == 0 || count > DXL_MOTOR_COUNT) {
+    return group;
+  }
+
+  // Distance of each axis from where its last goal left it
+  uint32_t distance[DXL_MOTOR_COUNT];
+  uint32_t longest = 1;
+  for (uint8_t i = 0; i < count; i++) {
+    int8_t idx = motorIndex(ids[i]);
+    if (idx < 0) {
+      return group;
+    }
+    uint8_t bit;
+    shadowSlot(ids[i], ADDR_GOAL_POSITION, bit);
+    int32_t from = (shadow[idx].valid & bit) ? axis_goal[idx] : readPresentPosition(ids[i]);
+    distance[i] = abs(goals[i] - from);
+    longest = max(longest, distance[i]);
+  }
+
+  // Accel, velocity, goal per axis (addresses 108..119)
+  uint8_t block[DXL_MOTOR_COUNT * 12];
+  int32_t accel[DXL_MOTOR_COUNT];
+  int32_t velocity[DXL_MOTOR_COUNT];
+  for (uint8_t i = 0; i < count; i++) {
+    int8_t idx = motorIndex(ids[i]);
+    uint8_t bit = 1 << idx;
+
+    // Remember the normal profile the first time an axis is overridden
+    if (!(profile_override & bit)) {
+      uint8_t item;
+      const MotorSetup& setup = MOTOR_SETUP[idx];
+      int32_t* slot = shadowSlot(ids[i], ADDR_PROFILE_ACCELERATION, item);
+      saved_profile_accel[idx] = (shadow[idx].valid & item) ? *slot : setup.accel;
+      slot = shadowSlot(ids[i], ADDR_PROFILE_VELOCITY, item);
+      saved_profile_velocity[idx] = (shadow[idx].valid & item) ? *slot : setup.velocity;
+      profile_override |= bit;
+    }
+
+    // 0 means unlimited on the motor, so never round a slow axis down to it
+    velocity[i] = max((uint32_t)1, (SEGMENT_VELOCITY * distance[i] + longest / 2) / longest);
+    accel[i] = (SEGMENT_ACCEL == 0) ? 0 : max((uint32_t)1, (SEGMENT_ACCEL * distance[i] + longest / 2) / longest);
+    memcpy(&block[i * 12], &accel[i], 4);
+    memcpy(&block[i * 12 + 4], &velocity[i], 4);
+    int32_t bus_goal = busGoal(ids[i], ADDR_GOAL_POSITION, goals[i]);
+    memcpy(&block[i * 12 + 8], &bus_goal, 4);
+  }
+
+  int8_t handle = scheduler.submitSyncWriteBlock(BUS_CLASS_GOAL, ADDR_PROFILE_ACCELERATION, 12, ids, block, count,
+                                                 micros() + BUS_GOAL_DEADLINE_US);
+  if (scheduler.wait(handle)) {
+    for (uint8_t i = 0; i < count; i++) {
+      shadowStore(ids[i], ADDR_PROFILE_ACCELERATION, accel[i]);
+      shadowStore(ids[i], ADDR_PROFILE_VELOCITY, velocity[i]);
+      shadowStore(ids[i], ADDR_GOAL_POSITION, goals[i]);
+    }
+  } else {
+    // Could not queue the block - send the items one by one
+    bus_stats.instruction[BUS_SYNC_WRITE].retries++;
+    bool success = true;
+    for (uint8_t i = 0; i < count; i++) {
+      success &= writeRegister(ids[i], ADDR_PROFILE_ACCELERATION, accel[i], 4);
+      success &= writeRegister(ids[i], ADDR_PROFILE_VELOCITY, velocity[i], 4);
+      success &= writeRegister(ids[i], ADDR_GOAL_POSITION, goals[i], 4);
+    }
+    if (!success) {
+      return group;
+    }
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    int8_t idx = motorIndex(ids[i]);
+    group.axes |= (1 << idx);
+    group.goal[idx] = goals[i];
+  }
+  group.started_ms = millis();
+  return group;
+}
+
+/**
+ * @brief Put back the normal profile of axes a coordinated move changed
+ *
+ * Called before every ordinary goal write, so only the first one after a
+ * drawing pattern pays for it.
+ */
+void HardwareControl::restoreProfiles(const uint8_t* ids, uint8_t count) {
+  uint8_t restore_ids[DXL_MOTOR_COUNT];
+  int32_t accel[DXL_MOTOR_COUNT];
+  int32_t velocity[DXL_MOTOR_COUNT];
+  uint8_t restore = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    int8_t idx = motorIndex(ids[i]);
+    if (idx < 0 || !(profile_override & (1 << idx)) || restore >= DXL_MOTOR_COUNT) {
+      continue;
+    }
+    profile_override &= ~(1 << idx);
+    restore_ids[restore] = ids[i];
+    accel[restore] = saved_profile_accel[idx];
+    velocity[restore] = saved_profile_velocity[idx];
+    restore++;
+  }
+  if (restore == 0) {
+    return;
+  }
+  syncWriteRegister(ADDR_PROFILE_ACCELERATION, 4, restore_ids, accel, restore);
+  syncWriteRegister(ADDR_PROFILE_VELOCITY, 4, restore_ids, velocity, restore);
+}
+
+/**
+ * @brief Scheduler callback for the motion group poll
+ */
+void HardwareControl::onGroupRead(void* ctx, const DxlTransport& result, bool ok) {
+  HardwareControl* self = static_cast<HardwareControl*>(ctx);
+  self->group_received = self->applyTelemetryStatus(result);
+}
+
+/**
+ * @brief Check a motion group once, reading only its axes
+ *
+ * An axis is done when it has stopped at its goal, or has stopped at all once
+ * MOTION_START_GRACE_MS has passed (blocked or clamped moves). Finished axes
+ * are removed from the group, so later polls read fewer motors.
+ * @param window If non-zero, an axis this close to its goal also counts as
+ *               done while still moving (path following)
+ * @return true when every axis of the group is done
+ */
+bool HardwareControl::pollGroup(MotionGroup& group, int32_t window) {
+  if (group.axes == 0) {
+    return true;
+  }
+
+  uint8_t ids[DXL_MOTOR_COUNT];
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+    if (group.axes & (1 << i)) {
+      ids[count++] = MOTOR_IDS[i];
+    }
+  }
+
+  // Telemetry block gives Moving and Present Position in one read
+  group_received = 0;
+  int8_t handle = scheduler.submitSyncRead(BUS_CLASS_INTERLOCK, ADDR_INDIRECT_DATA_1, sizeof(MotorTelemetry),
+                                           ids, count, micros() + BUS_INTERLOCK_DEADLINE_US,
+                                           &HardwareControl::onGroupRead, this);
+  scheduler.wait(handle);
+  bool complete_read = (group_received == count);
+  if (!complete_read) {
+    bus_stats.instruction[BUS_SYNC_READ].retries++;
+  }
+
+  bool started = (millis() - group.started_ms) >= MOTION_START_GRACE_MS;
+  for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+    if (!(group.axes & (1 << i))) {
+      continue;
+    }
+
+    bool moving;
+    bool at_goal = false;
+    if (complete_read) {
+      moving = telemetry.motor[i].moving != 0;
+      at_goal = abs(telemetry.motor[i].position - group.goal[i]) <= MOTION_GOAL_TOLERANCE;
+    } else {
+      moving = readMoving(MOTOR_IDS[i]);
+    }
+
+    bool in_window = complete_read && window > 0 &&
+                     abs(telemetry.motor[i].position - group.goal[i]) <= window;
+    if (in_window || (!moving && (at_goal || started))) {
+      group.axes &= ~(1 << i);
+    }
+  }
+  return group.axes == 0;
+}
+
+/**
+ * @brief Wait until every axis of a group is done
+ *
+ * Other axes may keep moving. A motor that faults on the way is recovered
+ * and re-sent its goal, and the start grace period begins again.
+ */
+void HardwareControl::waitForGroup(MotionGroup group) {
+  while (!pollGroup(group)) {
+    if (recoverFaults()) {
+      group.started_ms = millis();
+    }
+    serviceBus(MOTION_POLL_MS);
+  }
+}
+
+/**
+ * @brief Check whether a motor (or any motor when motorId is 0) is still moving
+ *
+ * The all-motors case uses a single Sync Read for MOVING + MOVING_STATUS and
+ * falls back to per-ID reads if any motor fails to answer.
+ */
+bool HardwareControl::anyMotorMoving(uint8_t motorId) {
+  if (motorId > 0) {
+    return readMoving(motorId);
+  }
+
+#if DXL_USE_SYNC_READ
+  moving_received = 0;
+  int8_t handle = scheduler.submitSyncRead(BUS_CLASS_INTERLOCK, ADDR_MOVING, sizeof(MovingSyncData),
+                                           MOTOR_IDS, DXL_MOTOR_COUNT, micros() + BUS_INTERLOCK_DEADLINE_US,
+                                           &HardwareControl::onMovingRead, this);
+  scheduler.wait(handle);
+  if (moving_received == DXL_MOTOR_COUNT) {
+    bool moving = false;
+    for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+      moving |= (moving_sync_data[i].moving != 0);
+    }
+    return moving;
+  }
+  // Sync Read incomplete - fall through to the per-ID reads
+  bus_stats.instruction[BUS_SYNC_READ].retries++;
+#endif
+
+  bool moving = false;
+  for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+    moving_sync_data[i].moving = readMoving(MOTOR_IDS[i]);
+    moving |= (moving_sync_data[i].moving != 0);
+  }
+  return moving;
+}
+
+/**
+ * @brief Wait for motors to complete their movement
+ */
+void HardwareControl::waitForMotors(uint8_t motorId) {
+  bool moving;
+
+  // Initial delay to allow motor controller to update status registers
+  serviceBus(50);
+
+  // If no motors appear to be moving initially, wait a bit more and check again
+  if (!anyMotorMoving(motorId)) {
+    serviceBus(50);
+
+    // If still no movement detected, assume completed quickly
+    if (!anyMotorMoving(motorId)) {
+      return;
+    }
+  }
+
+  // Main waiting loop - a motor that faults mid-move is recovered and re-sent its goal
+  do {
+    moving = anyMotorMoving(motorId) || recoverFaults();
+    serviceBus(5);
+  } while (moving);
+}
+
+
+/**
+ * @brief Wait for motors to complete their movement
+ */
+void HardwareControl::waitForMotorsMin(uint8_t motorId) {
+  bool moving;
+
+  // Initial delay to allow motor controller to update status registers
+  serviceBus(10);
+
+  // If no motors appear to be moving initially, wait a bit more and check again
+  if (!anyMotorMoving(motorId)) {
+    serviceBus(10);
+
+    // If still no movement detected, assume completed quickly
+    if (!anyMotorMoving(motorId)) {
+      return;
+    }
+  }
+
+  // Main waiting loop - a motor that faults mid-move is recovered and re-sent its goal
+  do {
+    moving = anyMotorMoving(motorId) || recoverFaults();
+    serviceBus(1);
+  } while (moving);
+}
+// ============================================================================
+// SEMANTIC WRAPPER FUNCTIONS (MATCH NUK COMMANDS)
+// ============================================================================
+
+/**
+ * @brief Move handler to work area (streaking station)
+ * MOVE WORK_AREA command implementation
+ */
+bool HardwareControl::moveToWorkArea() {
+  DEBUG_SERIAL.println("Moving to work area (streaking station)");
+  return rotateToStreakingStation();
+}
+
+/**
+ * @brief Move handler to storage position (restacker)
+ * MOVE STRG command implementation
+ */
+bool HardwareControl::moveToStorage() {
+  DEBUG_SERIAL.println("Moving to storage position");
+  return rotateHandlerToFinished();
+}
+
+/**
+ * @brief Move handler to normal cartridge position
+ * MOVE NORMAL command implementation
+ */
+bool HardwareControl::moveToNormal() {
+  DEBUG_SERIAL.println("Moving to normal cartridge position");
+  return rotateHandlerToC1();
+}
+
+/**
+ * @brief Move handler to blood cartridge position
+ * MOVE BLOOD command implementation
+ */
+bool HardwareControl::moveToBlood() {
+  DEBUG_SERIAL.println("Moving to blood cartridge position");
+  return rotateHandlerToC2();
+}
+
+/**
+ * @brief Move handler to chocolat cartridge position
+ * MOVE CHOCOLAT command implementation
+ */
+bool HardwareControl::moveToChocolat() {
+  DEBUG_SERIAL.println("Moving to chocolat cartridge position");
+  return rotateHandlerToC3();
+}
+
+// ============================================================================
+// LIFT SEMANTIC WRAPPER FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Lift storage (restacker) up
+ * LIFT STRG Top command implementation
+ */
+bool HardwareControl::liftStorageTop() {
+  DEBUG_SERIAL.println("Lifting storage top");
+  return moveRestackerTop();
+}
+
+/**
+ * @brief Lift storage (restacker) up
+ * LIFT STRG UP command implementation
+ */
+bool HardwareControl::liftStorageUp() {
+  DEBUG_SERIAL.println("Lifting storage up");
+  return moveRestackerUp();
+}
+
+/**
+ * @brief Lift storage (restacker) mid
+ * LIFT STRG MID command implementation
+ */
+bool HardwareControl::liftStorageMid() {
+  DEBUG_SERIAL.println("Lifting storage mid");
+  return moveRestackerMid();
+}
+
+/**
+ * @brief Lift storage (restacker) down
+ * LIFT STRG DOWN command implementation
+ */
+bool HardwareControl::liftStorageDown() {
+  DEBUG_SERIAL.println("Lifting storage down");
+  return moveRestackerDown();
+}
+
+/**
+ * @brief Lift normal cartridge top
+ * LIFT NORMAL UP command implementation
+ */
+bool HardwareControl::liftNormalTop() {
+  DEBUG_SERIAL.println("Lifting normal cartridge top");
+  return moveCartridgeTop(1);
+}
+
+/**
+ * @brief Lift normal cartridge up
+ * LIFT NORMAL UP command implementation
+ */
+bool HardwareControl::liftNormalUp() {
+  DEBUG_SERIAL.println("Lifting normal cartridge up");
+  return moveCartridgeUp(1);
+}
+
+/**
+ * @brief Lift normal cartridge mid
+ * LIFT NORMAL UP command implementation
+ */
+bool HardwareControl::liftNormalMid() {
+  DEBUG_SERIAL.println("Lifting normal cartridge mid");
+  return moveCartridgeMid(1);
+}
+
+/**
+ * @brief Lift normal cartridge down
+ * LIFT NORMAL DOWN command implementation
+ */
+bool HardwareControl::liftNormalDown() {
+  DEBUG_SERIAL.println("Lifting normal cartridge down");
+  return moveCartridgeDown(1);
+}
+
+/**
+ * @brief Lift blood cartridge top
+ * LIFT NORMAL UP command implementation
+ */
+bool HardwareControl::liftBloodTop() {
+  DEBUG_SERIAL.println("Lifting blood cartridge top");
+  return moveCartridgeTop(2);
+}
+
+/**
+ * @brief Lift blood cartridge up
+ * LIFT BLOOD UP command implementation
+ */
+bool HardwareControl::liftBloodUp() {
+  DEBUG_SERIAL.println("Lifting blood cartridge up");
+  return moveCartridgeUp(2);
+}
 
 /**
  * @brief Lift blood cartridge mid
@@ -527,11 +1815,8 @@ bool HardwareControl::liftAllTop() {
 }
 
 bool HardwareControl::liftAllTopNB(){
-  dxl.setGoalPosition(DXL_CARTRIDGE1, CARTRIDGE1_TOP);
-  dxl.setGoalPosition(DXL_CARTRIDGE2, CARTRIDGE2_TOP);
-  dxl.setGoalPosition(DXL_CARTRIDGE3, CARTRIDGE3_TOP);
-  dxl.setGoalPosition(DXL_RESTACKER, RESTACKER_TOP);
-  waitForMotors();
+  const int32_t goals[] = {(int32_t)CARTRIDGE1_TOP, (int32_t)CARTRIDGE2_TOP, (int32_t)CARTRIDGE3_TOP, (int32_t)RESTACKER_TOP};
+  waitForGroup(startMoves(CARTRIDGE_STACK_IDS, goals, 4));
   return true;
 }
 
@@ -550,11 +1835,8 @@ bool HardwareControl::liftAllUp() {
 }
 
 bool HardwareControl::liftAllUpNB(){
-  dxl.setGoalPosition(DXL_CARTRIDGE1, CARTRIDGE1_UP);
-  dxl.setGoalPosition(DXL_CARTRIDGE2, CARTRIDGE2_UP);
-  dxl.setGoalPosition(DXL_CARTRIDGE3, CARTRIDGE3_UP);
-  dxl.setGoalPosition(DXL_RESTACKER, RESTACKER_UP);
-  waitForMotors();
+  const int32_t goals[] = {(int32_t)CARTRIDGE1_UP, (int32_t)CARTRIDGE2_UP, (int32_t)CARTRIDGE3_UP, (int32_t)RESTACKER_UP};
+  waitForGroup(startMoves(CARTRIDGE_STACK_IDS, goals, 4));
   return true;
 }
 
@@ -572,11 +1854,8 @@ bool HardwareControl::liftAllMid() {
   return success;
 }
 bool HardwareControl::liftAllMidNB(){
-  dxl.setGoalPosition(DXL_CARTRIDGE1, CARTRIDGE1_MID);
-  dxl.setGoalPosition(DXL_CARTRIDGE2, CARTRIDGE2_MID);
-  dxl.setGoalPosition(DXL_CARTRIDGE3, CARTRIDGE3_MID);
-  dxl.setGoalPosition(DXL_RESTACKER, RESTACKER_MID);
-  waitForMotors();
+  const int32_t goals[] = {(int32_t)CARTRIDGE1_MID, (int32_t)CARTRIDGE2_MID, (int32_t)CARTRIDGE3_MID, (int32_t)RESTACKER_MID};
+  waitForGroup(startMoves(CARTRIDGE_STACK_IDS, goals, 4));
   return true;
 }
 
@@ -711,7 +1990,7 @@ bool HardwareControl::extrude() {
  * @return true if successful
  */
 bool HardwareControl::moveRestackerTop() {
-  dxl.setGoalPosition(DXL_RESTACKER, RESTACKER_TOP);
+  writeGoalPosition(DXL_RESTACKER, RESTACKER_TOP);
   waitForMotors(DXL_RESTACKER);
   return true;
 }
@@ -721,7 +2000,7 @@ bool HardwareControl::moveRestackerTop() {
  * @return true if successful
  */
 bool HardwareControl::moveRestackerUp() {
-  dxl.setGoalPosition(DXL_RESTACKER, RESTACKER_UP);
+  writeGoalPosition(DXL_RESTACKER, RESTACKER_UP);
   waitForMotors(DXL_RESTACKER);
   return true;
 }
@@ -731,7 +2010,7 @@ bool HardwareControl::moveRestackerUp() {
  * @return true if successful
  */
 bool HardwareControl::moveRestackerMid() {
-  dxl.setGoalPosition(DXL_RESTACKER, RESTACKER_MID);
+  writeGoalPosition(DXL_RESTACKER, RESTACKER_MID);
   waitForMotors(DXL_RESTACKER);
   return true;
 }
@@ -741,7 +2020,7 @@ bool HardwareControl::moveRestackerMid() {
  * @return true if successful
  */
 bool HardwareControl::moveRestackerDown() {
-  dxl.setGoalPosition(DXL_RESTACKER, RESTACKER_HOME);
+  writeGoalPosition(DXL_RESTACKER, RESTACKER_HOME);
   waitForMotors(DXL_RESTACKER);
   return true;
 }
@@ -754,19 +2033,19 @@ bool HardwareControl::moveRestackerDown() {
 bool HardwareControl::moveCartridgeTop(uint8_t cartridge_id) {
   switch (cartridge_id) {
     case 1:
-      dxl.setGoalPosition(DXL_CARTRIDGE1, CARTRIDGE1_TOP);
+      writeGoalPosition(DXL_CARTRIDGE1, CARTRIDGE1_TOP);
       waitForMotors(DXL_CARTRIDGE1);
       break;
     case 2:
-      dxl.setGoalPosition(DXL_CARTRIDGE2, CARTRIDGE2_TOP);
+      writeGoalPosition(DXL_CARTRIDGE2, CARTRIDGE2_TOP);
       waitForMotors(DXL_CARTRIDGE2);
       break;
     case 3:
-      dxl.setGoalPosition(DXL_CARTRIDGE3, CARTRIDGE3_TOP);
+      writeGoalPosition(DXL_CARTRIDGE3, CARTRIDGE3_TOP);
       waitForMotors(DXL_CARTRIDGE3);
       break;
     case 4:
-      dxl.setGoalPosition(DXL_RESTACKER, RESTACKER_TOP);
+      writeGoalPosition(DXL_RESTACKER, RESTACKER_TOP);
       waitForMotors(DXL_RESTACKER);
       break;
     default:
@@ -783,19 +2062,19 @@ bool HardwareControl::moveCartridgeTop(uint8_t cartridge_id) {
 bool HardwareControl::moveCartridgeUp(uint8_t cartridge_id) {
   switch (cartridge_id) {
     case 1:
-      dxl.setGoalPosition(DXL_CARTRIDGE1, CARTRIDGE1_UP);
+      writeGoalPosition(DXL_CARTRIDGE1, CARTRIDGE1_UP);
       waitForMotors(DXL_CARTRIDGE1);
       break;
     case 2:
-      dxl.setGoalPosition(DXL_CARTRIDGE2, CARTRIDGE2_UP);
+      writeGoalPosition(DXL_CARTRIDGE2, CARTRIDGE2_UP);
       waitForMotors(DXL_CARTRIDGE2);
       break;
     case 3:
-      dxl.setGoalPosition(DXL_CARTRIDGE3, CARTRIDGE3_UP);
+      writeGoalPosition(DXL_CARTRIDGE3, CARTRIDGE3_UP);
       waitForMotors(DXL_CARTRIDGE3);
       break;
     case 4:
-      dxl.setGoalPosition(DXL_RESTACKER, RESTACKER_UP);
+      writeGoalPosition(DXL_RESTACKER, RESTACKER_UP);
       waitForMotors(DXL_RESTACKER);
       break;
     default:
@@ -812,19 +2091,19 @@ bool HardwareControl::moveCartridgeUp(uint8_t cartridge_id) {
 bool HardwareControl::moveCartridgeMid(uint8_t cartridge_id) {
   switch (cartridge_id) {
     case 1:
-      dxl.setGoalPosition(DXL_CARTRIDGE1, CARTRIDGE1_MID);
+      writeGoalPosition(DXL_CARTRIDGE1, CARTRIDGE1_MID);
       waitForMotors(DXL_CARTRIDGE1);
       break;
     case 2:
-      dxl.setGoalPosition(DXL_CARTRIDGE2, CARTRIDGE2_MID);
+      writeGoalPosition(DXL_CARTRIDGE2, CARTRIDGE2_MID);
       waitForMotors(DXL_CARTRIDGE2);
       break;
     case 3:
-      dxl.setGoalPosition(DXL_CARTRIDGE3, CARTRIDGE3_MID);
+      writeGoalPosition(DXL_CARTRIDGE3, CARTRIDGE3_MID);
       waitForMotors(DXL_CARTRIDGE3);
       break;
     case 4:
-      dxl.setGoalPosition(DXL_RESTACKER, RESTACKER_MID);
+      writeGoalPosition(DXL_RESTACKER, RESTACKER_MID);
       waitForMotors(DXL_RESTACKER);
       break;
     default:
@@ -841,15 +2120,15 @@ bool HardwareControl::moveCartridgeMid(uint8_t cartridge_id) {
 bool HardwareControl::moveCartridgeDown(uint8_t cartridge_id) {
   switch (cartridge_id) {
     case 1:
-      dxl.setGoalPosition(DXL_CARTRIDGE1, CARTRIDGE1_HOME);
+      writeGoalPosition(DXL_CARTRIDGE1, CARTRIDGE1_HOME);
       waitForMotors(DXL_CARTRIDGE1);
       break;
     case 2:
-      dxl.setGoalPosition(DXL_CARTRIDGE2, CARTRIDGE2_HOME);
+      writeGoalPosition(DXL_CARTRIDGE2, CARTRIDGE2_HOME);
       waitForMotors(DXL_CARTRIDGE2);
       break;
     case 3:
-      dxl.setGoalPosition(DXL_CARTRIDGE3, CARTRIDGE3_HOME);
+      writeGoalPosition(DXL_CARTRIDGE3, CARTRIDGE3_HOME);
       waitForMotors(DXL_CARTRIDGE3);
       break;
     default:
@@ -863,11 +2142,8 @@ bool HardwareControl::moveCartridgeDown(uint8_t cartridge_id) {
  * @return true if successful
  */
 bool HardwareControl::homeAllCartridges() {
-  dxl.setGoalPosition(DXL_CARTRIDGE1, CARTRIDGE1_HOME);
-  dxl.setGoalPosition(DXL_CARTRIDGE2, CARTRIDGE2_HOME);
-  dxl.setGoalPosition(DXL_CARTRIDGE3, CARTRIDGE3_HOME);
-  dxl.setGoalPosition(DXL_RESTACKER, RESTACKER_HOME);
-  waitForMotors();
+  const int32_t goals[] = {(int32_t)CARTRIDGE1_HOME, (int32_t)CARTRIDGE2_HOME, (int32_t)CARTRIDGE3_HOME, (int32_t)RESTACKER_HOME};
+  waitForGroup(startMoves(CARTRIDGE_STACK_IDS, goals, 4));
   return true;
 }
 
@@ -914,50 +2190,56 @@ bool HardwareControl::closeGripper() {
 // ============================================================================
 
 bool HardwareControl::rotateToStreakingStation() {
-  if (!setHandlerGoalPosition(STREAKING_STATION)) {
+  MotionGroup group = startHandlerMove(STREAKING_STATION);
+  if (group.empty()) {
     return false;
   }
-  waitForMotors();
+  waitForGroup(group);
   return true;
 }
 
 bool HardwareControl::rotateHandlerToInitial() {
-  if (!setHandlerGoalPosition(HANDLER_HOME)) {
+  MotionGroup group = startHandlerMove(HANDLER_HOME);
+  if (group.empty()) {
     return false;
   }
-  waitForMotors();
+  waitForGroup(group);
   return true;
 }
 
 bool HardwareControl::rotateHandlerToC1() {
-  if (!setHandlerGoalPosition(HANDLER_C1)) {
+  MotionGroup group = startHandlerMove(HANDLER_C1);
+  if (group.empty()) {
     return false;
   }
-  waitForMotors();
+  waitForGroup(group);
   return true;
 }
 
 bool HardwareControl::rotateHandlerToC2() {
-  if (!setHandlerGoalPosition(HANDLER_C2)) {
+  MotionGroup group = startHandlerMove(HANDLER_C2);
+  if (group.empty()) {
     return false;
   }
-  waitForMotors();
+  waitForGroup(group);
   return true;
 }
 
 bool HardwareControl::rotateHandlerToC3() {
-  if (!setHandlerGoalPosition(HANDLER_C3)) {
+  MotionGroup group = startHandlerMove(HANDLER_C3);
+  if (group.empty()) {
     return false;
   }
-  waitForMotors();
+  waitForGroup(group);
   return true;
 }
 
 bool HardwareControl::rotateHandlerToFinished() {
-  if (!setHandlerGoalPosition(HANDLER_RESTACKER)) {
+  MotionGroup group = startHandlerMove(HANDLER_RESTACKER);
+  if (group.empty()) {
     return false;
   }
-  waitForMotors();
+  waitForGroup(group);
   return true;
 }
 
@@ -965,12 +2247,23 @@ bool HardwareControl::setHandlerGoalPosition(float position) {
   // Safety threshold - motors considered "up" if above home + threshold
   float thres = 50;
 
-  // Get current positions and check if motors are in "up" positions
-  float platform_pos = dxl.getPresentPosition(DXL_PLATFORM);
-  float restacker_pos = dxl.getPresentPosition(DXL_RESTACKER);
-  float c1_pos = dxl.getPresentPosition(DXL_CARTRIDGE1);
-  float c2_pos = dxl.getPresentPosition(DXL_CARTRIDGE2);
-  float c3_pos = dxl.getPresentPosition(DXL_CARTRIDGE3);
+  // Get current positions and check if motors are in "up" positions.
+  // Served from the axis state table - only re-read when it has gone stale.
+  float restacker_pos, c1_pos, c2_pos, c3_pos;
+
+  if (axisStateFresh() || refreshAxisState()) {
+    // A lift counts as up if it is there or has been commanded there
+    restacker_pos = max(axis_position[motorIndex(DXL_RESTACKER)], axis_goal[motorIndex(DXL_RESTACKER)]);
+    c1_pos = max(axis_position[motorIndex(DXL_CARTRIDGE1)], axis_goal[motorIndex(DXL_CARTRIDGE1)]);
+    c2_pos = max(axis_position[motorIndex(DXL_CARTRIDGE2)], axis_goal[motorIndex(DXL_CARTRIDGE2)]);
+    c3_pos = max(axis_position[motorIndex(DXL_CARTRIDGE3)], axis_goal[motorIndex(DXL_CARTRIDGE3)]);
+  } else {
+    bus_stats.instruction[BUS_SYNC_READ].retries++;
+    restacker_pos = readPresentPosition(DXL_RESTACKER);
+    c1_pos = readPresentPosition(DXL_CARTRIDGE1);
+    c2_pos = readPresentPosition(DXL_CARTRIDGE2);
+    c3_pos = readPresentPosition(DXL_CARTRIDGE3);
+  }
 
   // Check if any motor is above its home position (indicating "up" state)
   if (restacker_pos > (RESTACKER_HOME + thres) || c1_pos > (CARTRIDGE1_HOME + thres) || c2_pos > (CARTRIDGE2_HOME + thres) || c3_pos > (CARTRIDGE3_HOME + thres)) {
@@ -989,7 +2282,7 @@ bool HardwareControl::setHandlerGoalPosition(float position) {
   }
 
   // Safe to move - set goal position
-  dxl.setGoalPosition(DXL_HANDLER, position);
+  writeGoalPosition(DXL_HANDLER, position);
   return true;
 }
 
@@ -998,14 +2291,12 @@ bool HardwareControl::setHandlerGoalPosition(float position) {
 // ============================================================================
 
 bool HardwareControl::platformGearUp() {
-  dxl.setGoalPosition(DXL_PLATFORM, PLATFORM_UP);
-  waitForMotors();
+  waitForGroup(startMove(DXL_PLATFORM, extendedPlatformTicks((int32_t)PLATFORM_UP)));
   return true;
 }
 
 bool HardwareControl::platformGearDown() {
-  dxl.setGoalPosition(DXL_PLATFORM, PLATFORM_HOME);
-  waitForMotors();
+  waitForGroup(startMove(DXL_PLATFORM, extendedPlatformTicks(PLATFORM_HOME_TICKS)));
   return true;
 }
 
@@ -1026,178 +2317,502 @@ bool HardwareControl::platformSuctionOff() {
   return true;
 }
 
-bool HardwareControl::LidSuctionOn() {
-  digitalWrite(LID_SUCTION, HIGH);
+bool HardwareControl::LidSuctionOn() {
+  digitalWrite(LID_SUCTION, HIGH);
+  return true;
+}
+
+bool HardwareControl::LidSuctionOff() {
+  digitalWrite(LID_SOLENOID, HIGH);
+  digitalWrite(LID_SUCTION, LOW);
+  delay(100);
+  digitalWrite(LID_SOLENOID, LOW);
+  return true;
+}
+
+// ============================================================================
+// LID LIFTER FUNCTIONS
+// ============================================================================
+
+bool HardwareControl::lowerLidLifter() {
+  waitForGroup(startMove(DXL_LID_LIFTER, LID_LIFTER_DOWN));
+  return true;
+}
+
+bool HardwareControl::raiseLidLifter() {
+  waitForGroup(startMove(DXL_LID_LIFTER, LID_LIFTER_HOME));
+  return true;
+}
+
+// ============================================================================
+// POLAR ARM FUNCTIONS
+// ============================================================================
+
+bool HardwareControl::movePolarArmToVial() {
+  waitForGroup(startMove(DXL_POLAR_ARM, POLAR_ARM_TO_VIAL));
+  return true;
+}
+
+bool HardwareControl::movePolarArmToCutting() {
+  waitForGroup(startMove(DXL_POLAR_ARM, POLAR_ARM_TO_CUT));
+  return true;
+}
+
+bool HardwareControl::movePolarArmToPlatform() {
+  waitForGroup(startMove(DXL_POLAR_ARM, POLAR_ARM_SWABBING));
+  return true;
+}
+
+// ============================================================================
+// COORDINATE SYSTEM AND PATTERNS
+// ============================================================================
+
+uint16_t HardwareControl::degToRaw(float degrees) {
+  float d = fmod(degrees, 360.0f);
+  if (d < 0) d += 360.0f;
+  return uint16_t((d / 360.0f) * 4096.0f) & 0x0FFF;
+}
+
+float HardwareControl::rawToDeg(uint16_t raw) {
+  return (raw & 0x0FFF) * 360.0f / 4096.0f;
+}
+
+bool HardwareControl::homePosition() {
+  writeGoalPosition(DXL_PLATFORM, extendedPlatformTicks(PLATFORM_HOME_TICKS));
+  waitForMotors(DXL_PLATFORM);
+  writeGoalPosition(DXL_LID_LIFTER, (uint32_t)LID_LIFTER_HOME);
+  waitForMotors(DXL_LID_LIFTER);
+  const uint8_t ids[] = {DXL_POLAR_ARM, DXL_HANDLER};
+  const int32_t goals[] = {(int32_t)POLAR_ARM_NO_OBSTRUCT_HOME, (int32_t)HANDLER_HOME};
+  setGoalPositions(ids, goals, 2);
+  waitForMotors();
+  return true;
+}
+
+/**
+ * @brief Inverse kinematics of a platform point
+ * @param goals Filled with the polar arm and platform goals (raw)
+ */
+HardwareControl::PointResult HardwareControl::solvePlatformPoint(float rx, float ry, int32_t* goals) {
+  return solvePlatformPoint((PolarKinematics::q16_t)lroundf(rx * 65536.0f), (PolarKinematics::q16_t)lroundf(ry * 65536.0f),
+                            goals);
+}
+
+HardwareControl::PointResult HardwareControl::solvePlatformPoint(PolarKinematics::q16_t rx, PolarKinematics::q16_t ry,
+                                                                 int32_t* goals) {
+  PolarKinematics::Solution solution;
+  PointResult result = solvePoint(rx, ry, solution);
+  if (result != POINT_OK) {
+    recordJointPoint(0, 0, result == POINT_SKIPPED ? JOINT_SKIP : JOINT_UNREACHABLE);
+    return result;  // A skipped point does not stop the pattern
+  }
+
+  // Choose solution with minimum movement
+  uint8_t pick = PolarKinematics::chooseSolution(solution, current_polar_angle, current_platform_angle, first_move);
+  poseGoals(solution.lever[pick], solution.platform[pick], goals);
+  return POINT_OK;
+}
+
+/**
+ * @brief Both solutions of a platform point, no branch chosen yet
+ */
+HardwareControl::PointResult HardwareControl::solvePoint(PolarKinematics::q16_t rx, PolarKinematics::q16_t ry,
+                                                         PolarKinematics::Solution& solution) {
+  switch (KINEMATICS.solve(rx, ry, solution)) {
+    case PolarKinematics::NEAR_CENTER:
+      DEBUG_SERIAL.println("Skipping near-origin point (geometric singularity)");
+      return POINT_SKIPPED;
+    case PolarKinematics::UNREACHABLE:
+      DEBUG_SERIAL.println("No intersection possible - point cannot be reached");
+      return POINT_UNREACHABLE;
+    default:
+      return POINT_OK;
+  }
+}
+
+/**
+ * @brief Raw goals of the chosen pose, which becomes the current one
+ */
+void HardwareControl::poseGoals(PolarKinematics::angle_t lever, PolarKinematics::angle_t platform, int32_t* goals) {
+  first_move = false;
+  current_polar_angle = lever;
+  current_platform_angle = platform;
+
+  // Polar arm: standard position control, one turn of the binary angle
+  goals[0] = (PolarKinematics::toTicks((uint16_t)current_polar_angle) + POLAR_ARM_HOME_TICKS) & 0x0FFF;
+
+  // Platform: use extended position control to avoid discontinuities
+  int32_t platform_ticks = (PolarKinematics::toTicks((uint16_t)current_platform_angle) + PLATFORM_HOME_TICKS) & 0x0FFF;
+  goals[1] = extendedPlatformTicks(platform_ticks);
+}
+
+/**
+ * @brief Start the polar arm and platform toward a solved point
+ * @return The two-axis group, empty if the goals could not be sent
+ */
+MotionGroup HardwareControl::startPlatformGoals(const int32_t* goals) {
+  // One Sync Write so both axes start together
+  static const uint8_t ids[] = {DXL_POLAR_ARM, DXL_PLATFORM};
+  if (COORDINATED_SEGMENTS) {
+    // Scaled profiles - both axes also arrive together
+    return startCoordinatedMove(ids, goals, 2);
+  }
+  return startMoves(ids, goals, 2);
+}
+
+bool HardwareControl::drawPlatformPoint(float rx, float ry) {
+  int32_t goals[2];
+  switch (solvePlatformPoint(rx, ry, goals)) {
+    case POINT_SKIPPED:
+      return true;
+    case POINT_UNREACHABLE:
+      return false;
+    default:
+      break;
+  }
+
+  settlePlatformGoals(goals);
   return true;
 }
 
-bool HardwareControl::LidSuctionOff() {
-  digitalWrite(LID_SOLENOID, HIGH);
-  digitalWrite(LID_SUCTION, LOW);
-  delay(100);
-  digitalWrite(LID_SOLENOID, LOW);
-  return true;
+/**
+ * @brief Move the polar arm and platform to solved goals and wait for them to stop
+ */
+void HardwareControl::settlePlatformGoals(const int32_t* goals) {
+  if (COORDINATED_SEGMENTS) {
+    waitForGroup(startPlatformGoals(goals));
+  } else {
+    startPlatformGoals(goals);
+    waitForMotorsMin();
+  }
 }
 
 // ============================================================================
-// LID LIFTER FUNCTIONS
+// PATTERN PIPELINE
 // ============================================================================
+//
+// Between beginPath() and endPath() a pattern runs as a pipeline: the
+// drawing loop (or streamCurve(), a flash table, a PATH upload) generates
+// points, pathPoint() solves them, the branch plan commits them, and the
+// send stage passes the goals on to the bus. The stages are joined by the
+// plan window (plan_points) and the goal queue (path_queue); only a full
+// queue makes the generator wait. The send stage never waits for motion
+// itself - pumpPath() is called as each point is queued, so the next
+// points are solved while the axes are still moving to the current one.
 
-bool HardwareControl::lowerLidLifter() {
-  dxl.setGoalPosition(DXL_LID_LIFTER, LID_LIFTER_DOWN);
-  waitForMotors();
-  return true;
+/**
+ * @brief Start streaming a pattern
+ *
+ * pathPoint() then sends each goal while the previous one is still being
+ * approached (window or tick mode), or as soon as it has settled (stop
+ * mode), without waiting for the motion before solving the next point.
+ */
+void HardwareControl::beginPath() {
+  path_active = true;
+  path_group = MotionGroup();
+  path_sent_ms = millis();
+  path_poll_ms = path_sent_ms;
+  path_queue_head = 0;
+  path_queue_count = 0;
+  path_send_failed = false;
+  path_tail[0] = axis_goal[motorIndex(DXL_POLAR_ARM)];
+  path_tail[1] = axis_goal[motorIndex(DXL_PLATFORM)];
 }
 
-bool HardwareControl::raiseLidLifter() {
-  dxl.setGoalPosition(DXL_LID_LIFTER, LID_LIFTER_HOME);
-  waitForMotors();
-  return true;
+/**
+ * @brief Add the next point of a streamed pattern
+ *
+ * Solves it and queues its goals for the send stage. Outside
+ * beginPath()/endPath() it behaves like drawPlatformPoint(); between
+ * beginPlan() and endPlan() it only stores the point for the branch plan.
+ */
+bool HardwareControl::pathPoint(float rx, float ry) {
+  return pathPointFixed((PolarKinematics::q16_t)lroundf(rx * 65536.0f), (PolarKinematics::q16_t)lroundf(ry * 65536.0f));
 }
 
-// ============================================================================
-// POLAR ARM FUNCTIONS
-// ============================================================================
+/**
+ * @brief pathPoint() with the point already in Q16.16 millimetres
+ */
+bool HardwareControl::pathPointFixed(PolarKinematics::q16_t rx, PolarKinematics::q16_t ry) {
+  if (planning) {
+    return planPoint(rx, ry);
+  }
 
-bool HardwareControl::movePolarArmToVial() {
-  dxl.setGoalPosition(DXL_POLAR_ARM, POLAR_ARM_TO_VIAL);
-  waitForMotors();
-  return true;
-}
+  // Solve while the previous segment is still running
+  int32_t goals[2];
+  switch (solvePlatformPoint(rx, ry, goals)) {
+    case POINT_SKIPPED:
+      return true;
+    case POINT_UNREACHABLE:
+      return false;
+    default:
+      break;
+  }
 
-bool HardwareControl::movePolarArmToCutting() {
-  dxl.setGoalPosition(DXL_POLAR_ARM, POLAR_ARM_TO_CUT);
-  waitForMotors();
-  return true;
+  // Outside a path the goals settle, like drawPlatformPoint()
+  return solvedGoals(goals);
 }
 
-bool HardwareControl::movePolarArmToPlatform() {
-  dxl.setGoalPosition(DXL_POLAR_ARM, POLAR_ARM_SWABBING);
-  waitForMotors();
-  return true;
+/**
+ * @brief Stream goals solved here, through the platform centre if the segment passes it
+ *
+ * Goals solved ahead of time (flash tables, host trajectories, replays)
+ * already carry their centre poses and go to pathGoals() directly. The
+ * centre poses are recorded with the point, so a replay draws them as well.
+ */
+bool HardwareControl::solvedGoals(const int32_t* goals) {
+  int32_t center[2][2];
+  const int32_t from[2] = {path_active ? path_tail[0] : axis_goal[motorIndex(DXL_POLAR_ARM)],
+                           path_active ? path_tail[1] : axis_goal[motorIndex(DXL_PLATFORM)]};
+  uint8_t legs = centerPassGoals(from, goals, center);
+
+  bool success = true;
+  for (uint8_t i = 0; i < legs; i++) {
+    recordJointPoint(center[i][0], center[i][1] & 0x0FFF, 0);
+    success &= pathGoals(center[i]);
+  }
+  recordJointPoint(goals[0], goals[1] & 0x0FFF, 0);
+  success &= pathGoals(goals);
+  return success;
 }
 
-// ============================================================================
-// COORDINATE SYSTEM AND PATTERNS
-// ============================================================================
+/**
+ * @brief Stream goals as they are (see pathPoint())
+ * @return false if a goal sent since the last call could not be sent
+ */
+bool HardwareControl::pathGoals(const int32_t* goals) {
+  if (!path_active) {
+    settlePlatformGoals(goals);
+    return true;
+  }
 
-uint16_t HardwareControl::degToRaw(float degrees) {
-  float d = fmod(degrees, 360.0f);
-  if (d < 0) d += 360.0f;
-  return uint16_t((d / 360.0f) * 4096.0f) & 0x0FFF;
+  queuePathGoals(goals);
+
+  bool success = !path_send_failed;
+  path_send_failed = false;
+  return success;
 }
 
-float HardwareControl::rawToDeg(uint16_t raw) {
-  return (raw & 0x0FFF) * 360.0f / 4096.0f;
+/**
+ * @brief Centre poses to visit on the way from one pair of goals to the next (see CenterPass.h)
+ *
+ * The skipped points near the centre are what the pass draws. Only
+ * segments that nearCenter() lets through get the float test. The platform
+ * goals continue from 'from' and arrive at 'goals' the same way round.
+ * @param center Filled with up to two raw goal pairs, platform on its extended scale
+ * @return Number of poses (0 if the segment keeps clear of the centre)
+ */
+uint8_t HardwareControl::centerPassGoals(const int32_t* from, const int32_t* goals, int32_t (*center)[2]) {
+  if (CENTER_PASS_RADIUS <= 0) {
+    return 0;
+  }
+
+  PolarKinematics::angle_t lever_from = PolarKinematics::fromTicks(from[0] - POLAR_ARM_HOME_TICKS);
+  PolarKinematics::angle_t platform_from = PolarKinematics::fromTicks(from[1] - PLATFORM_HOME_TICKS);
+  PolarKinematics::angle_t lever_to = PolarKinematics::fromTicks(goals[0] - POLAR_ARM_HOME_TICKS);
+  PolarKinematics::angle_t platform_to = PolarKinematics::fromTicks(goals[1] - PLATFORM_HOME_TICKS);
+  if (!PolarKinematics::nearCenter(CENTER_GATE, lever_from, platform_from, lever_to, platform_to)) {
+    return 0;
+  }
+
+  PolarKinematics::CenterPass pass;
+  if (!PolarKinematics::centerPass(KINEMATICS, lever_from, platform_from, lever_to, platform_to, CENTER_PASS_RADIUS,
+                                   pass)) {
+    return 0;
+  }
+
+  // Shortest way between raw goals within one turn
+  const int32_t half = DXL_TICKS_PER_TURN / 2;
+  int32_t polar = (PolarKinematics::toTicks((uint16_t)pass.lever) + POLAR_ARM_HOME_TICKS) & 0x0FFF;
+  int32_t in = PolarKinematics::toTicks((uint16_t)pass.platform_in) + PLATFORM_HOME_TICKS;
+  int32_t out = PolarKinematics::toTicks((uint16_t)pass.platform_out) + PLATFORM_HOME_TICKS;
+  center[0][0] = polar;
+  center[0][1] = from[1] + (((in - from[1] + half) & (DXL_TICKS_PER_TURN - 1)) - half);
+  center[1][0] = polar;
+  center[1][1] = goals[1] - (((goals[1] - out + half) & (DXL_TICKS_PER_TURN - 1)) - half);
+  return (center[1][1] == center[0][1]) ? 1 : 2;
 }
 
-bool HardwareControl::homePosition() {
-  dxl.setGoalPosition(DXL_PLATFORM, (uint32_t)PLATFORM_HOME);
-  waitForMotors(DXL_PLATFORM);
-  dxl.setGoalPosition(DXL_LID_LIFTER, (uint32_t)LID_LIFTER_HOME);
-  waitForMotors(DXL_LID_LIFTER);
-  dxl.setGoalPosition(DXL_POLAR_ARM, (uint32_t)POLAR_ARM_NO_OBSTRUCT_HOME);
-  dxl.setGoalPosition(DXL_HANDLER, (uint32_t)HANDLER_HOME);
-  waitForMotors();
-  return true;
+/**
+ * @brief Hand goals to the send stage
+ *
+ * Only waits (servicing the bus) while the queue is full.
+ */
+void HardwareControl::queuePathGoals(const int32_t* goals) {
+  while (path_queue_count >= PATH_QUEUE_DEPTH) {
+    if (!pumpPath()) {
+      serviceBus(1);
+    }
+  }
+
+  int32_t* slot = path_queue[(path_queue_head + path_queue_count) % PATH_QUEUE_DEPTH];
+  slot[0] = goals[0];
+  slot[1] = goals[1];
+  path_queue_count++;
+  path_tail[0] = goals[0];
+  path_tail[1] = goals[1];
+
+  pumpPath();
 }
 
-bool HardwareControl::drawPlatformPoint(float rx, float ry) {
-  // Constrain to platform radius
-  float r = sqrt(rx * rx + ry * ry);
-  
-  if (r < 1.0f) {  // Within 1mm of center
-    DEBUG_SERIAL.println("Skipping near-origin point (geometric singularity)");
-    return true;  // Skip this point, continue pattern
-  }
-  
-  if (r > platform_radius) {
-    rx = (platform_radius / r) * rx;
-    ry = (platform_radius / r) * ry;
-  }
-
-  // Calculate original point angle in platform coordinates
-  float original_angle = atan2(ry, rx);
-  float platform_radius_point = sqrt(rx * rx + ry * ry);
-
-  // Find intersection of circles
-  float center_dist = sqrt(platform_center_x * platform_center_x + platform_center_y * platform_center_y);
-
-  // Check if circles can intersect
-  if (center_dist > POLAR_ARM_LENGTH + platform_radius_point || center_dist < abs(POLAR_ARM_LENGTH - platform_radius_point)) {
-    DEBUG_SERIAL.print("center_dist: ");
-    DEBUG_SERIAL.println(center_dist);
-    DEBUG_SERIAL.print("polar arm length: ");
-    DEBUG_SERIAL.println(POLAR_ARM_LENGTH);
-    DEBUG_SERIAL.print("platfrom radiu point: ");
-    DEBUG_SERIAL.println(platform_radius_point);
+/**
+ * @brief Send stage: pass queued goals on as soon as the segment in flight allows
+ * @return true if a goal was sent
+ */
+bool HardwareControl::pumpPath() {
+  bool sent = false;
+  while (path_queue_count > 0 && pathReady()) {
+    path_group = startPlatformGoals(path_queue[path_queue_head]);
+    path_sent_ms = millis();
+    path_poll_ms = path_sent_ms;
+    if (path_group.axes == 0) {
+      path_send_failed = true;
+    }
+    path_queue_head = (path_queue_head + 1) % PATH_QUEUE_DEPTH;
+    path_queue_count--;
+    sent = true;
+  }
+  return sent;
+}
 
+/**
+ * @brief true once the segment in flight is far enough along for the next goal
+ *
+ * Tick mode goes by PATH_TICK_MS since it was sent. Window mode waits for
+ * PATH_FOLLOW_TOLERANCE, stop mode for arrival; both poll the axes at most
+ * every MOTION_POLL_MS, so solving is not held up by the bus.
+ */
+bool HardwareControl::pathReady() {
+  if (PATH_FOLLOW_MODE == PATH_FOLLOW_TICK) {
+    return millis() - path_sent_ms >= PATH_TICK_MS;
+  }
+  if (path_group.axes == 0) {
+    return true;
+  }
+  if (millis() - path_poll_ms < MOTION_POLL_MS) {
     return false;
   }
+  path_poll_ms = millis();
 
-  // Calculate intersection parameters
-  float a = (POLAR_ARM_LENGTH * POLAR_ARM_LENGTH - platform_radius_point * platform_radius_point + center_dist * center_dist) / (2.0f * center_dist);
-  float h = sqrt(POLAR_ARM_LENGTH * POLAR_ARM_LENGTH - a * a);
-
-  // Center point along the line between circle centers
-  float x2 = platform_center_x * a / center_dist;
-  float y2 = platform_center_y * a / center_dist;
+  bool ready = pollGroup(path_group, PATH_FOLLOW_MODE == PATH_FOLLOW_WINDOW ? PATH_FOLLOW_TOLERANCE : 0);
+  if (!ready && recoverFaults()) {
+    path_group.started_ms = millis();
+  }
+  return ready;
+}
 
-  // Calculate both possible intersections
-  float intersection1_x = x2 + h * (-platform_center_y) / center_dist;
-  float intersection1_y = y2 + h * platform_center_x / center_dist;
+/**
+ * @brief Send what is still queued and let the last point of a streamed pattern settle
+ * @return false if any goal of the pattern could not be sent
+ */
+bool HardwareControl::endPath() {
+  if (!path_active) {
+    return true;
+  }
+  while (path_queue_count > 0) {
+    if (!pumpPath()) {
+      serviceBus(1);
+    }
+  }
+  waitForGroup(path_group);
+  path_active = false;
 
-  float intersection2_x = x2 - h * (-platform_center_y) / center_dist;
-  float intersection2_y = y2 - h * platform_center_x / center_dist;
+  bool success = !path_send_failed;
+  path_send_failed = false;
+  return success;
+}
 
-  // Calculate lever angles for both solutions
-  float lever_angle1 = atan2(intersection1_y, intersection1_x);
-  float lever_angle2 = atan2(intersection2_y, intersection2_x);
+// ============================================================================
+// WHOLE-PATTERN BRANCH PLAN
+// ============================================================================
+//
+// With BRANCH_PLAN_MODE set, pathPoint() only stores both solutions of each
+// point, and planBranches() chooses the branch sequence with the least
+// total travel (or the smallest largest step) before the points move. The
+// plan is a sliding window - the branch stage of the pattern pipeline: once
+// BRANCH_PLAN_POINTS are stored, all but the last BRANCH_PLAN_LOOKAHEAD are
+// committed and queued, and those are planned again with the points that
+// follow, starting from the pose the committed ones ended on. Motion starts
+// after the first window instead of after the whole pattern; on the drawing
+// primitives a 32-point lookahead picks the same branches as planning the
+// whole pattern at once. endPlan() commits the rest.
 
-  // Choose solution with minimum movement
-  float theta1, theta2;
-  float movement1, movement2;
+/**
+ * @brief Start a Cartesian pattern: beginPath(), and collect points for the plan
+ */
+void HardwareControl::beginPlan() {
+  beginPath();
+  planning = (BRANCH_PLAN_MODE != BRANCH_PLAN_GREEDY);
+  plan_count = 0;
+}
 
-  if (first_move) {
-    movement1 = abs(atan2(intersection1_y - platform_center_y, intersection1_x - platform_center_x) - original_angle);
-    movement2 = abs(atan2(intersection2_y - platform_center_y, intersection2_x - platform_center_x) - original_angle);
-    first_move = false;
-  } else {
-    movement1 = abs(lever_angle1 - current_polar_angle) + abs((atan2(intersection1_y - platform_center_y, intersection1_x - platform_center_x) - original_angle) - current_platform_angle);
-    movement2 = abs(lever_angle2 - current_polar_angle) + abs((atan2(intersection2_y - platform_center_y, intersection2_x - platform_center_x) - original_angle) - current_platform_angle);
-  }
-  //DEBUG_SERIAL.println("MOVEMENT 1");
-  //DEBUG_SERIAL.println(movement1);
-  //DEBUG_SERIAL.println("MOVEMENT 2");
-  // /DEBUG_SERIAL.println(movement2);
-  if (movement1 <= movement2) {
-    theta1 = lever_angle1;
-    theta2 = atan2(intersection1_y - platform_center_y, intersection1_x - platform_center_x) - original_angle;
-  } else {
-    theta1 = lever_angle2;
-    theta2 = atan2(intersection2_y - platform_center_y, intersection2_x - platform_center_x) - original_angle;
+/**
+ * @brief Store both solutions of a point for the plan
+ * @return false if the point cannot be reached (or a full block failed to stream)
+ */
+bool HardwareControl::planPoint(PolarKinematics::q16_t rx, PolarKinematics::q16_t ry) {
+  bool success = true;
+  if (plan_count >= BRANCH_PLAN_POINTS) {
+    success = flushPlan(BRANCH_PLAN_POINTS - BRANCH_PLAN_LOOKAHEAD);
   }
 
-  // Store current positions
-  current_polar_angle = theta1;
-  current_platform_angle = theta2;
+  PolarKinematics::Solution solution;
+  PointResult result = solvePoint(rx, ry, solution);
+  PolarKinematics::setPlanPoint(plan_points[plan_count++],
+                                result == POINT_OK ? PolarKinematics::SOLVED
+                                : result == POINT_SKIPPED ? PolarKinematics::NEAR_CENTER
+                                : PolarKinematics::UNREACHABLE,
+                                solution);
+  return success && result != POINT_UNREACHABLE;
+}
 
-  // Convert to motor positions
-  // Polar arm: standard position control
-  float deg1 = fmod(degrees(theta1), 360.0f);
-  if (deg1 < 0) deg1 += 360.0f;
-  deg1 = deg1 + (POLAR_ARM_HOME / 4096.0f * 360.0f);
+/**
+ * @brief Plan the stored points and stream the first 'commit' of them
+ *
+ * The others move to the front of the window, to be planned again.
+ */
+bool HardwareControl::flushPlan(uint16_t commit) {
+  const PolarKinematics::PlanCriterion criterion =
+    (BRANCH_PLAN_MODE == BRANCH_PLAN_PEAK) ? PolarKinematics::PLAN_PEAK_STEP : PolarKinematics::PLAN_TOTAL_TRAVEL;
+  PolarKinematics::planBranches(plan_points, plan_count, criterion, !first_move, current_polar_angle,
+                                current_platform_angle);
+
+  if (commit > plan_count) {
+    commit = plan_count;
+  }
+  bool success = true;
+  for (uint16_t i = 0; i < commit; i++) {
+    const PolarKinematics::PlanPoint& point = plan_points[i];
+    if (point.result != PolarKinematics::SOLVED) {
+      recordJointPoint(0, 0, point.result == PolarKinematics::NEAR_CENTER ? JOINT_SKIP : JOINT_UNREACHABLE);
+      continue;
+    }
+    int32_t goals[2];
+    poseGoals(point.lever[point.pick], point.platform[point.pick], goals);
+    if (!solvedGoals(goals)) {
+      success = false;
+    }
+  }
+  memmove(plan_points, plan_points + commit, (plan_count - commit) * sizeof(PolarKinematics::PlanPoint));
+  plan_count -= commit;
+  return success;
+}
 
-  // Platform: use extended position control to avoid discontinuities
-  float deg2 = degrees(theta2) + (PLATFORM_HOME / 4096.0f * 360.0f);
-  //DEBUG_SERIAL.println("CHECK 1");
-  // Set motor positions
-  dxl.setGoalPosition(DXL_POLAR_ARM, degToRaw(deg1));
-  dxl.setGoalPosition(DXL_PLATFORM, extendedPlatformPosition(deg2));  // Use extended position
-
-  waitForMotorsMin();
-  //DEBUG_SERIAL.println("CHECK 2");
-  return true;
+/**
+ * @brief Draw what is left of the plan and let the last point settle
+ * @param complete false to drop the unplanned points instead (abort)
+ */
+bool HardwareControl::endPlan(bool complete) {
+  bool success = true;
+  if (planning) {
+    if (complete) {
+      success = flushPlan(plan_count);
+    }
+    planning = false;
+    plan_count = 0;
+  }
+  success &= endPath();
+  return success;
 }
 
 bool HardwareControl::moveToCoordinate(float x, float y) {
@@ -1208,15 +2823,29 @@ bool HardwareControl::drawLine(float x1, float y1, float x2, float y2, int num_p
   num_points = max(2, num_points);
   bool success = true;
 
-  for (int i = 0; i < num_points; i++) {
-    float t = (float)i / (num_points - 1);
-    float rx = x1 + t * (x2 - x1);
-    float ry = y1 + t * (y2 - y1);
+  const float params[] = {x1, y1, x2, y2, (float)num_points};
+  uint32_t key = trajectoryKey(TRAJECTORY_LINE, params, 5);
+  if (replayTrajectory(key, success)) {
+    return success;
+  }
 
-    if (!drawPlatformPoint(rx, ry)) {
-      success = false;
+  recordTrajectory(key);
+  beginPlan();
+  if (CHORD_TOLERANCE_MM > 0) {
+    success = streamCurve(*this, PolarKinematics::LineCurve{x1, y1, x2, y2}, 1);
+  } else {
+    for (int i = 0; i < num_points; i++) {
+      float t = (float)i / (num_points - 1);
+      float rx = x1 + t * (x2 - x1);
+      float ry = y1 + t * (y2 - y1);
+
+      if (!pathPoint(rx, ry)) {
+        success = false;
+      }
     }
   }
+  success &= endPlan();
+  endTrajectoryRecord(true);
 
   return success;
 }
@@ -1224,22 +2853,60 @@ bool HardwareControl::drawLine(float x1, float y1, float x2, float y2, int num_p
 bool HardwareControl::drawCircle(float radius, int num_points) {
   bool success = true;
 
-  for (int i = 0; i < num_points; i++) {
-    float angle = (2.0f * PI * i) / num_points;
-    float rx = radius * cos(angle);
-    float ry = radius * sin(angle);
+  const float params[] = {radius, (float)num_points};
+  uint32_t key = trajectoryKey(TRAJECTORY_CIRCLE, params, 2);
+  if (replayTrajectory(key, success)) {
+    return success;
+  }
 
-    if (!drawPlatformPoint(rx, ry)) {
-      success = false;
+  recordTrajectory(key);
+  beginPlan();
+  if (CHORD_TOLERANCE_MM > 0) {
+    success = streamCurve(*this, PolarKinematics::CircleCurve{radius}, CHORD_SEGMENTS_PER_TURN);
+  } else {
+    for (int i = 0; i < num_points; i++) {
+      float angle = (2.0f * PI * i) / num_points;
+      float rx = radius * cos(angle);
+      float ry = radius * sin(angle);
+
+      if (!pathPoint(rx, ry)) {
+        success = false;
+      }
     }
   }
+  success &= endPlan();
+  endTrajectoryRecord(true);
 
   return success;
 }
 
 bool HardwareControl::drawSpiral(float max_radius, float revolutions, int num_points) {
+  if (SPIRAL_CONTINUOUS) {
+    return drawSpiralContinuous(max_radius, revolutions);
+  }
+
+  bool success = true;
+
+  const float params[] = {max_radius, revolutions, (float)num_points};
+  uint32_t key = trajectoryKey(TRAJECTORY_SPIRAL, params, 3);
+  if (!replayTrajectory(key, success)) {
+    recordTrajectory(key);
+    success = drawSpiralPoints(max_radius, revolutions, num_points);
+    endTrajectoryRecord(true);
+  }
+  return success;
+}
+
+bool HardwareControl::drawSpiralPoints(float max_radius, float revolutions, int num_points) {
   bool success = true;
 
+  beginPlan();
+  if (CHORD_TOLERANCE_MM > 0) {
+    uint8_t segments = (uint8_t)constrain((int)ceilf(revolutions * CHORD_SEGMENTS_PER_TURN), 1, 255);
+    success = streamCurve(*this, PolarKinematics::SpiralCurve{max_radius, revolutions}, segments);
+    success &= endPlan();
+    return success;
+  }
   for (int i = 0; i < num_points; i++) {
     float t = (float) i / (num_points - 1);
     float angle = -t * revolutions * 2.0f * PI;
@@ -1250,70 +2917,316 @@ bool HardwareControl::drawSpiral(float max_radius, float revolutions, int num_po
     DEBUG_SERIAL.print(rx);
     DEBUG_SERIAL.print(",y: ");
     DEBUG_SERIAL.print(ry);
-    if (!drawPlatformPoint(rx, ry)) {
+    if (!pathPoint(rx, ry)) {
       DEBUG_SERIAL.println("FALSE?");
       success = false;
     }
   }
-  resetEncoder(DXL_PLATFORM);
+  success &= endPlan();
+  return success;
+}
+
+/**
+ * @brief Spiral drawn with the platform turning at a constant SPIRAL_PLATFORM_RPM
+ *
+ * The platform gets a single goal on its extended scale, the whole spiral's
+ * turns away, with its profile velocity set to the spiral speed - it stays
+ * in extended position mode with torque on. The polar arm follows the
+ * platform: every SPIRAL_ARM_PERIOD_MS the platform's Present Position is
+ * read back, and the arm is set to the radius the spiral has after the
+ * turns made since the start. Acceleration, load and a slower motor than
+ * the profile asks for therefore only slow the spiral down, they do not
+ * bend it. The arm angle only depends on the radius, so one solve per
+ * update is enough and the stylus never stops; the duration is about
+ * revolutions / rpm, not the number of bus round trips. As in the discrete
+ * spiral, the part inside POINT_MIN_RADIUS is left out.
+ *
+ * Swinging out, the arm also moves the stylus around the platform centre a
+ * little (the platform angle of a point on the x axis changes with its
+ * radius). Left alone that bends the spiral by up to ~2 mm, so the turns
+ * are corrected for it - two passes bring it under 0.01 mm.
+ */
+bool HardwareControl::drawSpiralContinuous(float max_radius, float revolutions) {
+  float start_radius = POINT_MIN_RADIUS * 1.01f;
+  if (revolutions <= 0 || max_radius <= start_radius) {
+    return false;
+  }
+
+  // Where the spiral leaves the centre, reached like any other point
+  float start_turns = revolutions * start_radius / max_radius;
+  float angle = -start_turns * 2.0f * PI;
+  first_move = true;
+  if (!drawPlatformPoint(start_radius * cos(angle), start_radius * sin(angle))) {
+    return false;
+  }
+
+  // Keep the branch that point was reached on; the same radius on the x axis
+  // has the same arm angle, and its platform angle is 'angle' further on
+  PolarKinematics::Solution solution;
+  KINEMATICS.solve(start_radius, 0.0f, solution);
+  uint8_t branch = PolarKinematics::chooseSolution(solution, current_polar_angle,
+                                                   current_platform_angle + PolarKinematics::fromRadians(angle), false);
+  PolarKinematics::angle_t start_phase = solution.platform[branch];
+
+  // Platform turns to the end of the spiral, with the same correction as the arm schedule below
+  KINEMATICS.solve(max_radius, 0.0f, solution);
+  float end_turns = revolutions - start_turns +
+                    PolarKinematics::wrapHalfTurn(solution.platform[branch] - start_phase) / (float)PolarKinematics::TURN;
+
+  // Platform: one move at the spiral speed, the way drawSpiralPoints() turns the dish
+  const uint8_t platform_id = DXL_PLATFORM;
+  const int8_t platform_idx = motorIndex(DXL_PLATFORM);
+  int32_t start_ticks = cumulative_platform_ticks;
+  restoreProfiles(&platform_id, 1);
+  writeRegister(DXL_PLATFORM, ADDR_PROFILE_VELOCITY, lroundf(SPIRAL_PLATFORM_RPM / DXL_VELOCITY_UNIT_RPM), 4);
+  cumulative_platform_ticks += lroundf(end_turns * DXL_TICKS_PER_TURN);
+  last_platform_ticks = cumulative_platform_ticks & (DXL_TICKS_PER_TURN - 1);
+  MotionGroup platform = startMoves(&platform_id, &cumulative_platform_ticks, 1);
+
+  // Arm: radius from the turns the platform has made so far. pollGroup()
+  // reads its Present Position and tells when the move is over; a platform
+  // that stops short of its goal (blocked, or never started) leaves the arm
+  // where the spiral got to.
+  bool success = true;
+  while (true) {
+    bool stopped = pollGroup(platform);
+    int32_t position = telemetry.motor[platform_idx].position;
+    bool stopped_short = stopped && abs(position - cumulative_platform_ticks) > MOTION_GOAL_TOLERANCE;
+    float platform_turns = (position - start_ticks) / (float)DXL_TICKS_PER_TURN;
+    float turns = start_turns + platform_turns;
+    for (uint8_t pass = 0; pass < 2; pass++) {
+      KINEMATICS.solve(max_radius * constrain(turns, start_turns, revolutions) / revolutions, 0.0f, solution);
+      turns = start_turns + platform_turns -
+              PolarKinematics::wrapHalfTurn(solution.platform[branch] - start_phase) / (float)PolarKinematics::TURN;
+    }
+    bool done = stopped || turns >= revolutions;
+    turns = (done && !stopped_short) ? revolutions : constrain(turns, start_turns, revolutions);
+    if (stopped_short) {
+      success = false;
+    }
+    if (KINEMATICS.solve(max_radius * turns / revolutions, 0.0f, solution) == PolarKinematics::SOLVED) {
+      current_polar_angle = solution.lever[branch];
+      writeGoalPosition(DXL_POLAR_ARM,
+                        (PolarKinematics::toTicks((uint16_t)current_polar_angle) + POLAR_ARM_HOME_TICKS) & 0x0FFF);
+    } else {
+      success = false;
+    }
+    if (done) {
+      break;
+    }
+    if (recoverFaults()) {
+      // A rebooted axis has lost its place in the spiral - stop the platform where it is
+      success = false;
+      syncPlatformTicks();
+      writeGoalPosition(DXL_PLATFORM, cumulative_platform_ticks);
+      break;
+    }
+    serviceBus(SPIRAL_ARM_PERIOD_MS);
+  }
+
+  // Let the platform finish its move, then back to the normal profile
+  waitForMotors(DXL_PLATFORM);
+  waitForMotors(DXL_POLAR_ARM);
+  writeRegister(DXL_PLATFORM, ADDR_PROFILE_VELOCITY, MOTOR_SETUP[motorIndex(DXL_PLATFORM)].velocity, 4);
+  first_move = true;
   return success;
 }
 
 bool HardwareControl::drawFlower(float radius, float amplitude, int petals, int num_points) {
   bool success = true;
 
-  for (int i = 0; i < num_points; i++) {
-    float angle = (2.0f * PI * i) / num_points;
-    float r = radius + amplitude * sin(petals * angle);
-    float rx = r * cos(angle);
-    float ry = r * sin(angle);
+  const float params[] = {radius, amplitude, (float)petals, (float)num_points};
+  uint32_t key = trajectoryKey(TRAJECTORY_FLOWER, params, 4);
+  if (replayTrajectory(key, success)) {
+    return success;
+  }
 
-    if (!drawPlatformPoint(rx, ry)) {
-      success = false;
+  recordTrajectory(key);
+  beginPlan();
+  if (CHORD_TOLERANCE_MM > 0) {
+    // Each petal needs its own starting spans to be resolved at all
+    uint8_t segments = (uint8_t)constrain(CHORD_SEGMENTS_PER_TURN * max(petals, 1), 1, 255);
+    success = streamCurve(*this, PolarKinematics::FlowerCurve{radius, amplitude, petals}, segments);
+  } else {
+    for (int i = 0; i < num_points; i++) {
+      float angle = (2.0f * PI * i) / num_points;
+      float r = radius + amplitude * sin(petals * angle);
+      float rx = r * cos(angle);
+      float ry = r * sin(angle);
+
+      if (!pathPoint(rx, ry)) {
+        success = false;
+      }
     }
   }
+  success &= endPlan();
+  endTrajectoryRecord(true);
 
   return success;
 }
 
+/**
+ * @brief Draw one of the built-in patterns from its precomputed joint table
+ *
+ * Unknown IDs draw the default line (the last table entry).
+ */
 bool HardwareControl::executeStreakPattern(uint8_t pattern_id) {
-  switch (pattern_id) {
-    case 0:  // Simple 3-streak pattern
-      return drawLine(-40, 0, 40, 0, 60);
-
-    case 1:  // Spiral streak
-      return drawSpiral(20, 2, 50);
-
-    case 2:  // Quadrant streak
-      {
-        bool success = drawLine(-25, -25, 25, -25, 20);
-        success &= drawLine(25, -25, 25, 25, 20);
-        success &= drawLine(25, 25, -25, 25, 20);
-        success &= drawLine(-25, 25, -25, -25, 20);
-        return success;
-      }
+  if (pattern_id >= STREAK_PATTERN_COUNT) {
+    pattern_id = STREAK_PATTERN_COUNT - 1;
+  }
+  if (SPIRAL_CONTINUOUS && pattern_id == STREAK_SPIRAL_ID) {
+    return drawSpiral(STREAK_SPIRAL.max_radius, STREAK_SPIRAL.revolutions, STREAK_SPIRAL.points);
+  }
+  const StreakPattern& pattern = STREAK_PATTERNS[pattern_id];
 
-    case 3:  // Zigzag streak
-      {
-        float x = -30;
-        float y = -30;
-        float step = 10;
-        bool success = true;
+  return runJointTable(pattern.points, pattern.count);
+}
 
-        success &= drawPlatformPoint(x, y);
+/**
+ * @brief Stream a precomputed joint table through the path follower
+ *
+ * Points flagged JOINT_STOP end the current stream so the stylus settles
+ * on them.
+ */
+bool HardwareControl::runJointTable(const JointPoint* points, uint16_t count) {
+  bool success = true;
 
-        for (int i = 0; i < 6; i++) {
-          y = (i % 2 == 0) ? 30 : -30;
-          x += step;
-          success &= drawPlatformPoint(x, y);
-        }
+  beginPath();
+  for (uint16_t i = 0; i < count; i++) {
+    const JointPoint& point = points[i];
+    if (point.flags & JOINT_UNREACHABLE) {
+      success = false;
+    }
+    if (!(point.flags & (JOINT_SKIP | JOINT_UNREACHABLE | JOINT_EMPTY))) {
+      success &= pathJointPoint(point.polar, point.platform);
+    }
+    if (point.flags & JOINT_STOP) {
+      success &= endPath();
+      beginPath();
+    }
+  }
+  success &= endPath();
+  return success;
+}
 
-        return success;
-      }
+/**
+ * @brief Stream a point whose joint goals were solved ahead of time
+ *
+ * The branch was chosen elsewhere (flash table or host), so the next point
+ * solved on the board picks its own afresh. Only the platform's multi-turn
+ * unwrapping happens here.
+ */
+bool HardwareControl::pathJointPoint(uint16_t polar, uint16_t platform) {
+  int32_t goals[2] = {polar & 0x0FFF, extendedPlatformTicks(platform & 0x0FFF)};
+  first_move = true;
+  return pathGoals(goals);
+}
 
-    default:
-      return drawLine(-30, 0, 30, 0, 30);
+// ============================================================================
+// SOLVED-TRAJECTORY CACHE
+// ============================================================================
+//
+// A parametric pattern is solved point by point the first time it is drawn;
+// the joint goals are recorded on the way, and later draws with the same key
+// replay them through runJointTable() without any inverse kinematics. The
+// cache is RAM only, so a reflash with new geometry starts empty, and the
+// key includes GEOMETRY_VERSION as well.
+
+/**
+ * @brief Cache key of a pattern kind and its parameters
+ */
+uint32_t HardwareControl::trajectoryKey(TrajectoryKind kind, const float* params, uint8_t count) {
+  uint32_t key = mixKey(GEOMETRY_VERSION, kind);
+  for (uint8_t i = 0; i < count; i++) {
+    uint32_t bits;
+    memcpy(&bits, &params[i], sizeof(bits));
+    key = mixKey(key, bits);
+  }
+  return key;
+}
+
+/**
+ * @brief Draw a cached pattern
+ * @param success Set to the result of the replay
+ * @return false if the key is not cached - the caller solves and records it
+ */
+bool HardwareControl::replayTrajectory(uint32_t key, bool& success) {
+  for (uint8_t i = 0; i < TRAJECTORY_CACHE_SLOTS; i++) {
+    TrajectorySlot& slot = trajectory_cache[i];
+    if (slot.valid && slot.key == key) {
+      slot.used_ms = millis();
+      success = runJointTable(slot.points, slot.count);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Start recording the joint goals solved from here on under 'key'
+ *
+ * Replaces an empty slot, or the least recently used one. The first point
+ * picks its branch afresh, as a replay would.
+ */
+void HardwareControl::recordTrajectory(uint32_t key) {
+  uint8_t pick = 0;
+  for (uint8_t i = 0; i < TRAJECTORY_CACHE_SLOTS; i++) {
+    if (!trajectory_cache[i].valid) {
+      pick = i;
+      break;
+    }
+    if ((int32_t)(trajectory_cache[i].used_ms - trajectory_cache[pick].used_ms) < 0) {
+      pick = i;
+    }
+  }
+
+  TrajectorySlot& slot = trajectory_cache[pick];
+  slot.valid = false;
+  slot.key = key;
+  slot.count = 0;
+  recording_slot = pick;
+  recording_overflow = false;
+  first_move = true;
+}
+
+void HardwareControl::recordJointPoint(uint16_t polar, uint16_t platform, uint8_t flags) {
+  if (recording_slot < 0) {
+    return;
+  }
+  TrajectorySlot& slot = trajectory_cache[recording_slot];
+  if (slot.count >= TRAJECTORY_CACHE_POINTS) {
+    recording_overflow = true;
+    return;
+  }
+  JointPoint& point = slot.points[slot.count++];
+  point.polar = polar;
+  point.platform = platform;
+  point.flags = flags;
+}
+
+/**
+ * @brief Stop recording; the slot is kept only if the whole pattern fitted
+ * @param complete false if the pattern was cut short (abort)
+ */
+void HardwareControl::endTrajectoryRecord(bool complete) {
+  if (recording_slot < 0) {
+    return;
+  }
+  TrajectorySlot& slot = trajectory_cache[recording_slot];
+  slot.valid = complete && !recording_overflow;
+  slot.used_ms = millis();
+  recording_slot = -1;
+}
+
+/**
+ * @brief Forget every cached trajectory
+ */
+void HardwareControl::clearTrajectoryCache() {
+  for (uint8_t i = 0; i < TRAJECTORY_CACHE_SLOTS; i++) {
+    trajectory_cache[i].valid = false;
+    trajectory_cache[i].used_ms = 0;
   }
+  recording_slot = -1;
 }
 
 // ============================================================================
@@ -1321,16 +3234,16 @@ bool HardwareControl::executeStreakPattern(uint8_t pattern_id) {
 // ============================================================================
 
 bool HardwareControl::shakeHandler() {
-  float pos = dxl.getPresentPosition(DXL_HANDLER);
+  float pos = readPresentPosition(DXL_HANDLER);
 
   for (int i = 0; i < 10; i++) {
-    dxl.setGoalPosition(DXL_HANDLER, pos + 50);
+    writeGoalPosition(DXL_HANDLER, pos + 50);
     waitForMotors(DXL_HANDLER);
-    dxl.setGoalPosition(DXL_HANDLER, pos - 50);
+    writeGoalPosition(DXL_HANDLER, pos - 50);
     waitForMotors(DXL_HANDLER);
   }
 
-  dxl.setGoalPosition(DXL_HANDLER, pos);
+  writeGoalPosition(DXL_HANDLER, pos);
   waitForMotors(DXL_HANDLER);
 
   return true;
@@ -1338,21 +3251,29 @@ bool HardwareControl::shakeHandler() {
 
 
 
-bool HardwareControl::resetEncoder(uint8_t motorId) {
-  dxl.torqueOff(motorId);
-  dxl.setOperatingMode(motorId, OP_POSITION);
-  dxl.setOperatingMode(motorId, 4);
-  dxl.torqueOn(motorId);
-  dxl.writeControlTableItem(ControlTableItem::PROFILE_VELOCITY, motorId, 100);
-  return true;
-}
-
 uint16_t HardwareControl::getMotorPosition(uint8_t motorId) {
-  return dxl.getPresentPosition(motorId);
+  int8_t idx = motorIndex(motorId);
+  if (idx >= 0 && axisStateFresh()) {
+    return axis_position[idx];
+  }
+  return readPresentPosition(motorId);
 }
 
 bool HardwareControl::isMotorMoving(uint8_t motorId) {
-  return dxl.readControlTableItem(ControlTableItem::MOVING, motorId) != 0;
+  int8_t idx = motorIndex(motorId);
+  if (idx >= 0 && axisStateFresh()) {
+    return axis_moving[idx] != 0;
+  }
+  return readMoving(motorId);
+}
+
+uint32_t HardwareControl::getBusBaudRate() const {
+  return dxl_baud_rate;
+}
+
+uint8_t HardwareControl::getMovingStatus(uint8_t motorId) {
+  int8_t idx = motorIndex(motorId);
+  return (idx < 0) ? 0 : moving_sync_data[idx].moving_status;
 }
 
 bool HardwareControl::isDishPresent() {
@@ -13,6 +13,104 @@
 #include <Wire.h>
 #include <Servo.h>
 #include "Config.h"
+#include "DxlTransport.h"
+#include "DxlScheduler.h"
+#include <PolarKinematics.h>
+#include <BranchPlanner.h>
+#include "PatternTables.h"
+
+
+/**
+ * @brief Per-motor telemetry, laid out exactly like the indirect data block
+ *
+ * initialize() maps these control-table items into Indirect Data 1.. of every
+ * motor, so one Sync Read of that block fills the whole struct.
+ */
+struct MotorTelemetry {
+  int32_t position;        // Present Position (raw)
+  int32_t velocity;        // Present Velocity (raw)
+  int16_t current;         // Present Current / Present Load (raw)
+  uint8_t temperature;     // Present Temperature (degC)
+  uint8_t moving;          // Moving flag
+  uint8_t moving_status;   // Moving Status bitfield
+  uint8_t hardware_error;  // Hardware Error Status bitfield
+} __attribute__((packed));
+
+/**
+ * @brief Telemetry of every motor from one bus transaction
+ */
+struct TelemetrySnapshot {
+  MotorTelemetry motor[DXL_MOTOR_COUNT];  // Same order as the bus poll
+  uint8_t received;                       // Motors that answered the last read
+  uint32_t timestamp_ms;                  // millis() when the read completed
+};
+
+/**
+ * @brief Axes commanded by one move, so the caller waits on just those
+ *
+ * Returned by the start*() functions. Groups can be merged with add() to
+ * run independent motions at the same time.
+ */
+struct MotionGroup {
+  uint8_t axes;                     // Bit per motor in bus poll order (0 = nothing commanded)
+  int32_t goal[DXL_MOTOR_COUNT];    // Goal of each commanded axis (raw)
+  uint32_t started_ms;              // millis() when the latest goal was sent
+
+  MotionGroup() : axes(0), started_ms(0) {}
+
+  bool empty() const {
+    return axes == 0;
+  }
+
+  void add(const MotionGroup& other) {
+    for (uint8_t i = 0; i < DXL_MOTOR_COUNT; i++) {
+      if (other.axes & (1 << i)) {
+        goal[i] = other.goal[i];
+      }
+    }
+    axes |= other.axes;
+    if ((int32_t)(other.started_ms - started_ms) > 0) {
+      started_ms = other.started_ms;
+    }
+  }
+};
+
+/**
+ * @brief Dynamixel instruction classes tracked by the bus statistics
+ */
+enum BusInstruction {
+  BUS_READ,        // Read (and Ping)
+  BUS_WRITE,       // Write
+  BUS_SYNC_READ,   // Sync Read
+  BUS_SYNC_WRITE,  // Sync Write
+  BUS_INSTRUCTION_COUNT
+};
+
+/**
+ * @brief Counters for one instruction class
+ *
+ * Byte counts are Protocol 2.0 packet sizes before byte stuffing.
+ */
+struct BusInstructionStats {
+  uint32_t packets;                          // Instruction packets sent
+  uint32_t tx_bytes;                         // Instruction bytes on the wire
+  uint32_t rx_bytes;                         // Status bytes received
+  uint32_t retries;                          // Transfers repeated by a fallback path
+  uint32_t timeouts;                         // No (complete) status before the timeout
+  uint32_t crc_errors;                       // Status packet failed CRC
+  uint32_t other_errors;                     // Any other library or status error
+  uint32_t busy_us;                          // Total time spent inside the call
+  uint32_t max_us;                           // Slowest single call
+  uint32_t latency[BUS_LATENCY_BUCKETS];     // Call duration histogram
+};
+
+/**
+ * @brief Bus statistics since the last reset
+ */
+struct BusStats {
+  BusInstructionStats instruction[BUS_INSTRUCTION_COUNT];
+  uint32_t since_ms;                         // millis() at the last reset
+};
 
 /**
  * @class HardwareControl
@@ -22,35 +120,182 @@ class HardwareControl {
   private:
     // Dynamixel interface
     Dynamixel2Arduino dxl;
+    DxlTransport transport;  // Non-blocking exchanges on the same port
+    DxlScheduler scheduler;  // Orders transport traffic: goals > interlock reads > telemetry
     
     // Servo objects for gripper control
     Servo servo1;
     Servo servo2;
     
     // Position tracking variables
-    float current_polar_angle;
-    float current_platform_angle;
+    PolarKinematics::angle_t current_polar_angle;     // Last arm solution
+    PolarKinematics::angle_t current_platform_angle;  // Last platform solution
     bool is_initialized;
     bool first_move;
+    uint32_t dxl_baud_rate;  // Rate the bus ended up at after negotiation
     
-    // Platform geometry parameters
-    float platform_center_x;
-    float platform_center_y;
-    float platform_radius;
-    
+    // Sync Read of MOVING + MOVING_STATUS for all motors in one packet
+    struct MovingSyncData {
+      uint8_t moving;
+      uint8_t moving_status;
+    } __attribute__((packed));
+
+    MovingSyncData moving_sync_data[DXL_MOTOR_COUNT];
+    uint8_t moving_received;           // Motors that answered the last poll
+    uint8_t group_received;            // Motors that answered the last motion group poll
+
+    // Sync Read of the indirect telemetry block, run through the transport
+    TelemetrySnapshot telemetry;
+    uint8_t telemetry_next;            // Next MOTOR_IDS index of a background sweep (0 = idle)
+    bool telemetry_in_flight;          // A sweep read is queued or running
+    uint8_t telemetry_sweep_received;  // Motors that answered so far in the sweep
+    uint32_t telemetry_sweep_ms;       // millis() when the sweep started
+
+    // Axis state table (struct-of-arrays, indexed like the bus poll order)
+    int32_t axis_position[DXL_MOTOR_COUNT];  // Present Position (raw)
+    int32_t axis_goal[DXL_MOTOR_COUNT];      // Last goal sent (raw)
+    int32_t axis_turn_offset[DXL_MOTOR_COUNT];  // Whole turns the motor's count is ahead of the axis (ticks)
+    uint8_t axis_moving[DXL_MOTOR_COUNT];    // Moving flag
+    int16_t axis_load[DXL_MOTOR_COUNT];      // Present Current / Load (raw)
+    uint32_t axis_state_ms;                  // millis() of the last complete refresh
+    bool axis_state_valid;
+
+    // Dynamixel bus counters (BUSSTATS)
+    BusStats bus_stats;
+
+    // Shadow of the writable control-table items, so unchanged writes are skipped
+    enum ShadowItem {
+      SHADOW_RETURN_DELAY_TIME,
+      SHADOW_DRIVE_MODE,
+      SHADOW_OPERATING_MODE,
+      SHADOW_TORQUE_ENABLE,
+      SHADOW_STATUS_RETURN_LEVEL,
+      SHADOW_PROFILE_ACCELERATION,
+      SHADOW_PROFILE_VELOCITY,
+      SHADOW_GOAL_POSITION,    // Value lives in axis_goal
+      SHADOW_ITEM_COUNT
+    };
+    struct ControlTableShadow {
+      uint8_t valid;                        // Bit per ShadowItem holding a known value
+      int32_t value[SHADOW_ITEM_COUNT];
+    };
+    ControlTableShadow shadow[DXL_MOTOR_COUNT];
+
+    // Per-segment profiles of coordinated moves, and what to put back afterwards
+    uint8_t profile_override;                    // Bit per MOTOR_IDS index running a segment profile
+    int32_t saved_profile_accel[DXL_MOTOR_COUNT];
+    int32_t saved_profile_velocity[DXL_MOTOR_COUNT];
+
+    // Streaming path follower (see PATTERN PIPELINE in hardware.cpp)
+    bool path_active;
+    MotionGroup path_group;     // Segment in flight
+    uint32_t path_sent_ms;      // millis() when it was sent
+    uint32_t path_poll_ms;      // millis() of the last poll of the segment in flight
+    int32_t path_queue[PATH_QUEUE_DEPTH][2];  // Solved goals waiting for the bus (send stage)
+    uint8_t path_queue_head;
+    uint8_t path_queue_count;
+    int32_t path_tail[2];       // Last goals queued - where the next segment starts
+    bool path_send_failed;      // A queued goal could not be sent
+
+    // Whole-pattern branch plan: points between beginPlan() and endPlan() are solved here first
+    bool planning;
+    uint16_t plan_count;
+    PolarKinematics::PlanPoint plan_points[BRANCH_PLAN_POINTS];
+
+    // Solved joint sequences of parametric patterns, keyed by trajectoryKey()
+    struct TrajectorySlot {
+      bool valid;
+      uint32_t key;
+      uint32_t used_ms;         // millis() of the last record or replay (LRU)
+      uint16_t count;
+      JointPoint points[TRAJECTORY_CACHE_POINTS];
+    };
+    TrajectorySlot trajectory_cache[TRAJECTORY_CACHE_SLOTS];
+    int8_t recording_slot;      // Slot solvePlatformPoint() appends to, -1 if none
+    bool recording_overflow;    // Pattern longer than a slot - not cached
+
+    // Hardware error recovery
+    uint8_t fault_pending;   // Bit per MOTOR_IDS index with a reported hardware error
+    bool in_recovery;
+
+    // Bus state
+    uint8_t status_return_level;  // Active Status Return Level (2 = writes are acknowledged)
+
     // Internal utility functions
     uint16_t degToRaw(float degrees);
     float rawToDeg(uint16_t raw);
+    static int8_t motorIndex(uint8_t motorId);
+    uint32_t negotiateBaudRate();
+    uint8_t applyTelemetryStatus(const DxlTransport& result);
+    void loadAxisState();
+    void pollTelemetrySweep();
+    void serviceBus(uint32_t ms);
+    void busIdle();
+
+    // Scheduler callbacks
+    static void onTelemetrySnapshot(void* ctx, const DxlTransport& result, bool ok);
+    static void onTelemetrySweep(void* ctx, const DxlTransport& result, bool ok);
+    static void onMovingRead(void* ctx, const DxlTransport& result, bool ok);
+    static void onGroupRead(void* ctx, const DxlTransport& result, bool ok);
+    static void onBusTransaction(void* ctx, uint8_t instruction, const DxlTransport& result);
+    bool mapTelemetryBlock(uint8_t motorId);
+    void applyStatusReturnLevel(uint8_t level);
+    bool syncWriteRegister(uint16_t addr, uint8_t len, const uint8_t* ids, const int32_t* values, uint8_t count);
+    bool writeRegister(uint8_t motorId, uint16_t addr, int32_t value, uint8_t len);
+    bool writeGoalPosition(uint8_t motorId, int32_t goal);
+    void configureMotor(uint8_t motorId);
+    void clearHomingTurns(uint8_t motorId);
+    void restoreProfiles(const uint8_t* ids, uint8_t count);
+    enum PointResult { POINT_OK, POINT_SKIPPED, POINT_UNREACHABLE };
+    PointResult solvePlatformPoint(float rx, float ry, int32_t* goals);
+    PointResult solvePlatformPoint(PolarKinematics::q16_t rx, PolarKinematics::q16_t ry, int32_t* goals);
+    PointResult solvePoint(PolarKinematics::q16_t rx, PolarKinematics::q16_t ry, PolarKinematics::Solution& solution);
+    void poseGoals(PolarKinematics::angle_t lever, PolarKinematics::angle_t platform, int32_t* goals);
+    bool planPoint(PolarKinematics::q16_t rx, PolarKinematics::q16_t ry);
+    bool flushPlan(uint16_t commit);
+    MotionGroup startPlatformGoals(const int32_t* goals);
+    bool solvedGoals(const int32_t* goals);
+    uint8_t centerPassGoals(const int32_t* from, const int32_t* goals, int32_t (*center)[2]);
+    void queuePathGoals(const int32_t* goals);
+    bool pumpPath();
+    bool pathReady();
+    void settlePlatformGoals(const int32_t* goals);
+    bool runJointTable(const JointPoint* points, uint16_t count);
+    void recordJointPoint(uint16_t polar, uint16_t platform, uint8_t flags);
+    bool drawSpiralPoints(float max_radius, float revolutions, int num_points);
+    bool drawSpiralContinuous(float max_radius, float revolutions);
+    void syncPlatformTicks();
+    void rebasePlatformTurns();
+    void syncTravelTurns();
+    bool recoverFaults();
+    bool recoverMotor(uint8_t motorId);
+    void restoreTurnCount(uint8_t motorId, int32_t last_position);
+    void recordBusTransfer(BusInstruction type, uint32_t start_us, uint16_t tx_bytes, uint16_t rx_bytes, bool ok);
+    void accountBusTransfer(BusInstruction type, uint32_t start_us, uint16_t tx_bytes, uint16_t rx_bytes, uint8_t lib_error);
+    bool busPing(uint8_t motorId);
+    bool busRead(uint8_t motorId, uint16_t addr, uint8_t len, int32_t& value);
+    int32_t busGoal(uint8_t motorId, uint16_t addr, int32_t value) const;
+    int32_t readPresentPosition(uint8_t motorId);
+    bool readMoving(uint8_t motorId);
+    int32_t* shadowSlot(uint8_t motorId, uint16_t addr, uint8_t& bit);
+    bool shadowMatches(uint8_t motorId, uint16_t addr, int32_t value);
+    void shadowStore(uint8_t motorId, uint16_t addr, int32_t value);
+    void shadowForget(uint8_t motorId, uint16_t addr);
+    bool syncReadRange(uint16_t addr, uint16_t len, uint8_t* dest);
+    void primeShadow();
+    bool refreshAxisState();
+    bool axisStateFresh() const;
+    bool anyMotorMoving(uint8_t motorId = 0);
     void waitForMotors(uint8_t motorId = 0);
     void waitForMotorsMin(uint8_t motorId = 0);
   
-    // ADD THESE for extended position tracking:
-    float cumulative_platform_degrees;  // Track total rotation
-    float last_platform_degrees;        // Previous target in degrees
+    // Extended position tracking for the platform
+    int32_t cumulative_platform_ticks;  // Goal on the multi-turn scale
+    int32_t last_platform_ticks;        // Previous target within one turn
     
   public:
     HardwareControl();
-    int32_t extendedPlatformPosition(float target_degrees);
+    int32_t extendedPlatformTicks(int32_t target_ticks);
 
 
     // ========================================================================
@@ -58,6 +303,22 @@ class HardwareControl {
     // ========================================================================
     void initialize();
     void homeAllAxes();
+    void update();  // Call from loop() - keeps the axis state table fresh
+
+    // ========================================================================
+    // MULTI-AXIS MOTION
+    // ========================================================================
+    bool setGoalPositions(const uint8_t* ids, const int32_t* goals, uint8_t count);  // One Sync Write, all axes start together
+
+    // ========================================================================
+    // MOTION GROUPS
+    // ========================================================================
+    MotionGroup startMove(uint8_t motorId, int32_t goal);
+    MotionGroup startMoves(const uint8_t* ids, const int32_t* goals, uint8_t count);
+    MotionGroup startHandlerMove(float position);  // Empty group if the lift interlock refuses
+    MotionGroup startCoordinatedMove(const uint8_t* ids, const int32_t* goals, uint8_t count);
+    bool pollGroup(MotionGroup& group, int32_t window = 0);  // Drops arrived axes; true once all have
+    void waitForGroup(MotionGroup group);
 
     // ========================================================================
     // SEMANTIC MOVEMENT FUNCTIONS (Match NUK Commands)
@@ -160,10 +421,37 @@ class HardwareControl {
     bool executeStreakPattern(uint8_t pattern_id);
     bool drawPlatformPoint(float x, float y);
     bool moveToCoordinate(float x, float y);
+    // num_points only applies with CHORD_TOLERANCE_MM = 0 - otherwise points are placed adaptively
     bool drawLine(float x1, float y1, float x2, float y2, int num_points = 20);
     bool drawCircle(float radius, int num_points = 36);
     bool drawSpiral(float max_radius, float revolutions, int num_points = 50);
     bool drawFlower(float radius, float amplitude, int petals, int num_points = 50);
+
+    // Streaming path follower - points between beginPath() and endPath() are solved while the axes move
+    void beginPath();
+    bool pathPoint(float x, float y);
+    bool pathPointFixed(PolarKinematics::q16_t x, PolarKinematics::q16_t y);  // Q16.16 mm (uploaded patterns)
+    bool pathGoals(const int32_t* goals);
+    bool pathJointPoint(uint16_t polar, uint16_t platform);  // Raw goals within one turn, solved elsewhere
+    bool endPath();
+
+    // Whole-pattern branch plan (BRANCH_PLAN_MODE) - wraps beginPath()/endPath() for Cartesian patterns
+    void beginPlan();
+    bool endPlan(bool complete = true);
+
+    // Solved-trajectory cache: record a pattern's joint goals once, replay them for later dishes
+    enum TrajectoryKind {
+      TRAJECTORY_LINE = 1,
+      TRAJECTORY_CIRCLE,
+      TRAJECTORY_SPIRAL,
+      TRAJECTORY_FLOWER,
+      TRAJECTORY_UPLOAD       // Resident PATH upload: id and upload generation
+    };
+    static uint32_t trajectoryKey(TrajectoryKind kind, const float* params, uint8_t count);
+    bool replayTrajectory(uint32_t key, bool& success);
+    void recordTrajectory(uint32_t key);
+    void endTrajectoryRecord(bool complete);
+    void clearTrajectoryCache();
     
     // ========================================================================
     // UTILITY FUNCTIONS
@@ -172,11 +460,22 @@ class HardwareControl {
     bool homePosition();
     bool setHandlerGoalPosition(float position);
     bool shakeHandler();
-    bool resetEncoder(uint8_t motorId);
     
     // Motor status functions
     uint16_t getMotorPosition(uint8_t motorId);
     bool isMotorMoving(uint8_t motorId);
+    uint8_t getMovingStatus(uint8_t motorId);  // Last Moving Status from the Sync Read poll
+    uint32_t getBusBaudRate() const;
+
+    // Telemetry snapshot (one Sync Read of every motor's indirect block)
+    bool readTelemetry();
+    const TelemetrySnapshot& getTelemetry() const;
+    const MotorTelemetry* getMotorTelemetry(uint8_t motorId) const;
+
+    // Dynamixel bus statistics
+    const BusStats& getBusStats() const;
+    const BusClassStats& getBusClassStats(BusClass bus_class) const;
+    void resetBusStats();
     
     // Sensor functions (placeholders)
     bool isDishPresent();
@@ -0,0 +1,59 @@
+/**
+ * @file CompareReference.ino
+ * @brief Sweep the dish and compare the fixed-point solver with the float reference
+ *
+ * Prints the worst angle difference (in encoder ticks) and the time per solve
+ * of each implementation.
+ */
+
+#include <PolarKinematics.h>
+
+using namespace PolarKinematics;
+
+// Same geometry as the streaker sketches
+static constexpr Solver KINEMATICS(70.0, 70.0, 98.995, 45.0);
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial);
+
+  int32_t worst = 0;
+  uint32_t points = 0;
+  uint32_t fixed_us = 0;
+  uint32_t float_us = 0;
+
+  for (float x = -45.0f; x <= 45.0f; x += 1.5f) {
+    for (float y = -45.0f; y <= 45.0f; y += 1.5f) {
+      Solution fixed_solution, float_solution;
+
+      uint32_t start = micros();
+      Result fixed_result = KINEMATICS.solve(x, y, fixed_solution);
+      fixed_us += micros() - start;
+
+      start = micros();
+      Result float_result = KINEMATICS.solveFloat(x, y, float_solution);
+      float_us += micros() - start;
+
+      if (fixed_result != SOLVED || float_result != SOLVED) {
+        continue;
+      }
+      points++;
+      for (uint8_t k = 0; k < 2; k++) {
+        worst = max(worst, abs(wrapHalfTurn(fixed_solution.lever[k] - float_solution.lever[k])));
+        worst = max(worst, abs(wrapHalfTurn(fixed_solution.platform[k] - float_solution.platform[k])));
+      }
+    }
+  }
+
+  Serial.print("Points: ");
+  Serial.println(points);
+  Serial.print("Worst difference (ticks): ");
+  Serial.println(worst / 16.0f, 3);
+  Serial.print("Fixed point (us/solve): ");
+  Serial.println((float)fixed_us / points, 1);
+  Serial.print("Float reference (us/solve): ");
+  Serial.println((float)float_us / points, 1);
+}
+
+void loop() {
+}
@@ -0,0 +1,159 @@
+/**
+ * @file BranchPlanner.h
+ * @brief Arm/platform branch choice over a whole pattern
+ *
+ * Every point has two solutions (the arm meets the point's circle twice).
+ * chooseSolution() picks greedily against the previous point only, which
+ * can leave the pattern on a branch that needs a large platform swing a
+ * few points later. planBranches() instead solves the sequence as a
+ * shortest path over the two branches per point (dynamic programming,
+ * two states per point) and keeps, for each point, which branch of the
+ * previous one led to it; a backward pass then reads off the plan.
+ *
+ * The step cost is the same as chooseSolution()'s: wrapped arm travel plus
+ * wrapped platform travel. Two criteria are offered - least total travel,
+ * or smallest largest single step (ties broken on total travel).
+ */
+
+#ifndef BRANCH_PLANNER_H
+#define BRANCH_PLANNER_H
+
+#include "PolarKinematics.h"
+
+namespace PolarKinematics {
+
+enum PlanCriterion {
+  PLAN_TOTAL_TRAVEL,  // Least arm + platform travel over the pattern
+  PLAN_PEAK_STEP      // Smallest largest step, then least travel
+};
+
+/**
+ * @brief Travel of a plan up to some point (binary angle units)
+ */
+struct PlanCost {
+  int32_t total;  // Sum of all steps
+  int32_t peak;   // Largest single step
+};
+
+/**
+ * @brief Travel between two poses, as chooseSolution() weighs it
+ */
+constexpr int32_t stepCost(angle_t lever_from, angle_t platform_from, angle_t lever_to, angle_t platform_to) {
+  return angleCost(wrapHalfTurn(lever_to - lever_from)) + angleCost(wrapHalfTurn(platform_to - platform_from));
+}
+
+constexpr PlanCost addStep(const PlanCost& cost, int32_t step) {
+  return PlanCost{cost.total + step, step > cost.peak ? step : cost.peak};
+}
+
+/**
+ * @brief Cost of starting a pattern on a branch with no current pose
+ *
+ * Only the platform rotation counts, as on chooseSolution()'s first move;
+ * it is not a drawing step, so it does not count toward the peak.
+ */
+constexpr PlanCost firstCost(angle_t platform) {
+  return PlanCost{angleCost(wrapHalfTurn(platform)), 0};
+}
+
+/**
+ * @brief true if cost a is at least as good as b (ties keep branch 0, as chooseSolution())
+ */
+constexpr bool notWorse(const PlanCost& a, const PlanCost& b, PlanCriterion criterion) {
+  return criterion == PLAN_PEAK_STEP
+         ? (a.peak < b.peak || (a.peak == b.peak && a.total <= b.total))
+         : (a.total < b.total || (a.total == b.total && a.peak <= b.peak));
+}
+
+// ============================================================================
+// RUN-TIME PLANNER
+// ============================================================================
+
+/**
+ * @brief One pattern point as the planner keeps it
+ *
+ * Angles are wrapped to half a turn, which is all the step cost looks at,
+ * so they fit in 16 bits.
+ */
+struct PlanPoint {
+  int16_t lever[2];
+  int16_t platform[2];
+  uint8_t result;  // Result of the solver - only SOLVED points are planned
+  uint8_t from;    // Bit b: branch of the previous solved point on the best way to branch b
+  uint8_t pick;    // Planned branch, after planBranches()
+};
+
+inline void setPlanPoint(PlanPoint& point, Result result, const Solution& solution) {
+  for (uint8_t b = 0; b < 2; b++) {
+    point.lever[b] = (int16_t)wrapHalfTurn(solution.lever[b]);
+    point.platform[b] = (int16_t)wrapHalfTurn(solution.platform[b]);
+  }
+  point.result = (uint8_t)result;
+  point.from = 0;
+  point.pick = 0;
+}
+
+/**
+ * @brief Choose the branch of every solved point
+ *
+ * Points that are not SOLVED are stepped over - the next solved point is
+ * weighed against the last solved one before them.
+ * @param have_start A pose is known (e.g. the end of the previous block of a
+ *                   long pattern); otherwise the first point starts fresh
+ * @return Cost of the plan
+ */
+inline PlanCost planBranches(PlanPoint* points, uint16_t count, PlanCriterion criterion, bool have_start,
+                             angle_t start_lever, angle_t start_platform) {
+  PlanCost cost[2] = {{0, 0}, {0, 0}};
+  int32_t last = -1;  // Last solved point so far
+
+  // Forward: best cost of reaching each branch of each solved point
+  for (uint16_t i = 0; i < count; i++) {
+    PlanPoint& point = points[i];
+    if (point.result != SOLVED) {
+      continue;
+    }
+    PlanCost reach[2];
+    point.from = 0;
+    for (uint8_t b = 0; b < 2; b++) {
+      if (last >= 0) {
+        const PlanPoint& previous = points[last];
+        PlanCost via0 = addStep(cost[0], stepCost(previous.lever[0], previous.platform[0],
+                                                  point.lever[b], point.platform[b]));
+        PlanCost via1 = addStep(cost[1], stepCost(previous.lever[1], previous.platform[1],
+                                                  point.lever[b], point.platform[b]));
+        bool zero = notWorse(via0, via1, criterion);
+        reach[b] = zero ? via0 : via1;
+        point.from |= (zero ? 0 : 1) << b;
+      } else if (have_start) {
+        reach[b] = addStep(PlanCost{0, 0}, stepCost(start_lever, start_platform, point.lever[b], point.platform[b]));
+      } else {
+        reach[b] = firstCost(point.platform[b]);
+      }
+    }
+    cost[0] = reach[0];
+    cost[1] = reach[1];
+    last = i;
+  }
+
+  if (last < 0) {
+    return PlanCost{0, 0};
+  }
+
+  // Backward: follow the kept branches from the cheaper end
+  uint8_t branch = notWorse(cost[0], cost[1], criterion) ? 0 : 1;
+  PlanCost best = cost[branch];
+  for (int32_t i = last; i >= 0; i--) {
+    PlanPoint& point = points[i];
+    if (point.result != SOLVED) {
+      continue;
+    }
+    point.pick = branch;
+    branch = (point.from >> branch) & 1;
+  }
+  return best;
+}
+
+}  // namespace PolarKinematics
+
+#endif // BRANCH_PLANNER_H
@@ -0,0 +1,243 @@
+/**
+ * @file CenterPass.h
+ * @brief Drawing through the platform centre
+ *
+ * The arm's circle runs through the platform centre, and there the two
+ * solutions of a point meet. Close to it the platform angle of a point
+ * follows the point's direction from the centre, which turns by half a
+ * turn over a few tenths of a millimetre: a segment passing near the
+ * centre becomes a large platform swing with the stylus off the segment,
+ * and the points inside the solver's minimum radius are not drawn at all.
+ *
+ * centerPass() re-parameterizes such a segment as three moves. The way in
+ * is radial: the platform is pre-rotated so the entry point's direction
+ * lies along the arm's tangent at the centre, and only the arm moves. On
+ * the centre the platform alone turns onto the exit point's direction -
+ * the stylus does not move over the dish. The way out is radial again. The
+ * stylus leaves the segment by at most its distance from the centre, so
+ * the pass is only taken where the direct joint move would stray further.
+ *
+ * Joint goals solved ahead of time carry their centre poses already: the
+ * pattern tables get them from centerPassConst(), the host trajectory tool
+ * from centerPass(). On the board only points solved there are checked,
+ * and nearCenter() keeps the float test to the few segments that can need it.
+ */
+
+#ifndef CENTER_PASS_H
+#define CENTER_PASS_H
+
+#include "PolarKinematics.h"
+
+namespace PolarKinematics {
+
+const uint8_t CENTER_PASS_SAMPLES = 8;  // Pieces the direct move is checked at
+constexpr double CENTER_PASS_GATE = 4.0;  // Radii out from the centre that nearCenter() looks at the ends
+
+/**
+ * @brief Poses on the platform centre between two points
+ */
+struct CenterPass {
+  angle_t lever;         // Stylus over the centre
+  angle_t platform_in;   // Entry point's direction along the arm's tangent
+  angle_t platform_out;  // Exit point's direction along the arm's tangent
+};
+
+/**
+ * @brief Platform angle on the centre that keeps a pose's point on the same radial line
+ *
+ * The branch of a pose is the side of the centre line its arm is on; each
+ * branch reaches the centre along its own tangent, a quarter turn either way.
+ */
+inline angle_t centerPlatform(const Solver& solver, angle_t center_lever, angle_t lever, angle_t platform) {
+  angle_t tangent = center_lever + (wrapHalfTurn(lever - center_lever) >= 0 ? TURN / 4 : -TURN / 4);
+  return wrapHalfTurn(platform + tangent - solver.centerHeading(lever));
+}
+
+/**
+ * @brief Centre poses for the segment between two poses, if it passes the centre
+ * @param radius Segments passing closer than this to the centre go through it (mm)
+ * @return false if the segment keeps clear, the direct move strays less, an
+ *         end is already on the centre or off the dish, or the arm cannot
+ *         reach the centre
+ */
+inline bool centerPass(const Solver& solver, angle_t lever_from, angle_t platform_from, angle_t lever_to,
+                       angle_t platform_to, float radius, CenterPass& pass) {
+  if (radius <= 0 || !solver.centerLever(pass.lever)) {
+    return false;
+  }
+
+  float ax, ay, bx, by;
+  solver.forward(lever_from, platform_from, ax, ay);
+  solver.forward(lever_to, platform_to, bx, by);
+  float a_sq = ax * ax + ay * ay;
+  float b_sq = bx * bx + by * by;
+  float edge_sq = 1.01f * solver.platformRadius() * solver.platformRadius();
+  if (a_sq < radius * radius || b_sq < radius * radius || a_sq > edge_sq || b_sq > edge_sq) {
+    return false;
+  }
+
+  // Closest approach of the segment; the ends are already known to be clear
+  float dx = bx - ax;
+  float dy = by - ay;
+  float t = -(ax * dx + ay * dy) / (dx * dx + dy * dy);
+  if (!(t > 0.0f && t < 1.0f)) {
+    return false;
+  }
+  float nx = ax + t * dx;
+  float ny = ay + t * dy;
+  float near_sq = nx * nx + ny * ny;
+  if (near_sq >= radius * radius) {
+    return false;
+  }
+
+  // Keep the direct move if it clearly stays closer to the segment (a shallow
+  // arc around the centre on one branch); on a par, the pass still takes the
+  // platform swing off the segment
+  float stray_sq = 0.0f;
+  for (uint8_t k = 1; k < CENTER_PASS_SAMPLES; k++) {
+    float s = (float)k / CENTER_PASS_SAMPLES;
+    float x, y;
+    solver.forward(lever_from + (angle_t)lroundf(s * wrapHalfTurn(lever_to - lever_from)),
+                   platform_from + (angle_t)lroundf(s * wrapHalfTurn(platform_to - platform_from)), x, y);
+    float cross = (x - ax) * dy - (y - ay) * dx;
+    stray_sq = fmaxf(stray_sq, cross * cross / (dx * dx + dy * dy));
+  }
+  if (stray_sq < 0.64f * near_sq) {
+    return false;
+  }
+
+  pass.platform_in = centerPlatform(solver, pass.lever, lever_from, platform_from);
+  pass.platform_out = centerPlatform(solver, pass.lever, lever_to, platform_to);
+  return true;
+}
+
+// ============================================================================
+// PRE-CHECK
+// ============================================================================
+
+/**
+ * @brief Centre lever and arm band for nearCenter(), folded at compile time
+ */
+struct CenterGate {
+  angle_t lever;  // Arm over the centre
+  angle_t band;   // Arm angle either side of it within CENTER_PASS_GATE radii of the centre
+};
+
+constexpr CenterGate centerGate(const Solver& solver, double radius) {
+  return CenterGate{solver.centerLeverConst(), solver.centerBandConst(CENTER_PASS_GATE * radius)};
+}
+
+/**
+ * @brief Integer test that a move may need centerPass()
+ *
+ * A segment passing within the radius of the centre has an end within
+ * CENTER_PASS_GATE radii of it, or changes branch, or - both ends further
+ * out on one branch, nearly opposite each other - turns the platform by
+ * well over a quarter turn.
+ * @return false if centerPass() would return false
+ */
+constexpr bool nearCenter(const CenterGate& gate, angle_t lever_from, angle_t platform_from, angle_t lever_to,
+                          angle_t platform_to) {
+  return angleCost(wrapHalfTurn(lever_from - gate.lever)) < gate.band ||
+         angleCost(wrapHalfTurn(lever_to - gate.lever)) < gate.band ||
+         (wrapHalfTurn(lever_from - gate.lever) >= 0) != (wrapHalfTurn(lever_to - gate.lever) >= 0) ||
+         angleCost(wrapHalfTurn(platform_to - platform_from)) > TURN / 4;
+}
+
+// ============================================================================
+// COMPILE TIME
+// ============================================================================
+// centerPass() as constexpr expressions in double precision, for the
+// pattern tables (PatternTables.h).
+
+/**
+ * @brief Result of centerPassConst()
+ */
+struct CenterPassResult {
+  bool pass;
+  CenterPass poses;
+};
+
+/**
+ * @brief The two poses of a move, as centerPass() takes them
+ */
+struct CenterMove {
+  angle_t lever_from;
+  angle_t platform_from;
+  angle_t lever_to;
+  angle_t platform_to;
+};
+
+constexpr CenterPassResult NO_CENTER_PASS = CenterPassResult{false, CenterPass{0, 0, 0}};
+
+constexpr angle_t centerPlatformConst(const Solver& solver, angle_t center_lever, angle_t lever, angle_t platform) {
+  return wrapHalfTurn(platform + center_lever + (wrapHalfTurn(lever - center_lever) >= 0 ? TURN / 4 : -TURN / 4) -
+                      solver.centerHeadingConst(lever));
+}
+
+constexpr double dishSq(const DishPoint& p) {
+  return p.x * p.x + p.y * p.y;
+}
+
+// Squared distance of p from the line through a along d
+constexpr double centerCrossSq(const DishPoint& p, const DishPoint& a, const DishPoint& d) {
+  return ((p.x - a.x) * d.y - (p.y - a.y) * d.x) * ((p.x - a.x) * d.y - (p.y - a.y) * d.x) / dishSq(d);
+}
+
+// Furthest the direct move strays from the segment, checked from piece k on
+constexpr double centerStrayConst(const Solver& solver, const CenterMove& move, const DishPoint& a, const DishPoint& d,
+                                  int k) {
+  return k >= CENTER_PASS_SAMPLES ? 0.0
+       : constMax(centerCrossSq(solver.forwardConst(
+                                  move.lever_from + roundToInt((double)k / CENTER_PASS_SAMPLES *
+                                                               wrapHalfTurn(move.lever_to - move.lever_from)),
+                                  move.platform_from + roundToInt((double)k / CENTER_PASS_SAMPLES *
+                                                                  wrapHalfTurn(move.platform_to - move.platform_from))),
+                                a, d),
+                  centerStrayConst(solver, move, a, d, k + 1));
+}
+
+constexpr CenterPassResult centerPassStray(const Solver& solver, const CenterMove& move, double radius,
+                                           const DishPoint& a, const DishPoint& d, double near_sq) {
+  return (near_sq >= radius * radius || centerStrayConst(solver, move, a, d, 1) < 0.64 * near_sq)
+         ? NO_CENTER_PASS
+         : CenterPassResult{true, CenterPass{solver.centerLeverConst(),
+                                             centerPlatformConst(solver, solver.centerLeverConst(), move.lever_from,
+                                                                 move.platform_from),
+                                             centerPlatformConst(solver, solver.centerLeverConst(), move.lever_to,
+                                                                 move.platform_to)}};
+}
+
+constexpr CenterPassResult centerPassNear(const Solver& solver, const CenterMove& move, double radius,
+                                          const DishPoint& a, const DishPoint& d, double t) {
+  return !(t > 0.0 && t < 1.0) ? NO_CENTER_PASS
+       : centerPassStray(solver, move, radius, a, d, dishSq(DishPoint{a.x + t * d.x, a.y + t * d.y}));
+}
+
+constexpr CenterPassResult centerPassSegment(const Solver& solver, const CenterMove& move, double radius,
+                                             const DishPoint& a, const DishPoint& d) {
+  return centerPassNear(solver, move, radius, a, d, -(a.x * d.x + a.y * d.y) / dishSq(d));
+}
+
+constexpr CenterPassResult centerPassEnds(const Solver& solver, const CenterMove& move, double radius,
+                                          const DishPoint& a, const DishPoint& b) {
+  return (dishSq(a) < radius * radius || dishSq(b) < radius * radius ||
+          dishSq(a) > 1.01 * solver.platformRadiusConst() * solver.platformRadiusConst() ||
+          dishSq(b) > 1.01 * solver.platformRadiusConst() * solver.platformRadiusConst())
+         ? NO_CENTER_PASS
+         : centerPassSegment(solver, move, radius, a, DishPoint{b.x - a.x, b.y - a.y});
+}
+
+/**
+ * @brief Compile-time centerPass()
+ */
+constexpr CenterPassResult centerPassConst(const Solver& solver, const CenterMove& move, double radius) {
+  return (radius <= 0.0 || !solver.reachesCenterConst())
+         ? NO_CENTER_PASS
+         : centerPassEnds(solver, move, radius, solver.forwardConst(move.lever_from, move.platform_from),
+                          solver.forwardConst(move.lever_to, move.platform_to));
+}
+
+}  // namespace PolarKinematics
+
+#endif // CENTER_PASS_H
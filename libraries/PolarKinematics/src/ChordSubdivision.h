@@ -0,0 +1,166 @@
+/**
+ * @file ChordSubdivision.h
+ * @brief Adaptive point placement for drawing primitives
+ *
+ * Between two goals the arm and platform move (roughly) linearly in joint
+ * space, so the stylus follows the forward kinematics of the interpolated
+ * pose, not the straight chord of the drawing. subdivideChords() walks a
+ * parametric curve and only inserts a point where that joint-space path
+ * would stray from the curve by more than a tolerance - straight-ish parts
+ * get few points, strongly curved parts (near the platform centre, tight
+ * petals) get more.
+ *
+ * Each span is checked at its midpoint and halved until it is within
+ * tolerance or CHORD_MAX_DEPTH is reached. Points are handed to the sink in
+ * drawing order as soon as they are final, so they can be streamed.
+ */
+
+#ifndef CHORD_SUBDIVISION_H
+#define CHORD_SUBDIVISION_H
+
+#include "PolarKinematics.h"
+
+namespace PolarKinematics {
+
+const uint8_t CHORD_MAX_DEPTH = 6;  // Each starting span is split into at most 2^6 pieces
+
+// ============================================================================
+// CURVES (t runs from 0 to 1)
+// ============================================================================
+// Same shapes as the sketches' drawLine(), drawCircle(), drawSpiral() and
+// drawFlower(); the closed ones end back on their first point.
+
+struct LineCurve {
+  float x1, y1, x2, y2;
+  void at(float t, float& x, float& y) const {
+    x = x1 + t * (x2 - x1);
+    y = y1 + t * (y2 - y1);
+  }
+};
+
+struct CircleCurve {
+  float radius;
+  void at(float t, float& x, float& y) const {
+    float angle = 2.0f * (float)M_PI * t;
+    x = radius * cosf(angle);
+    y = radius * sinf(angle);
+  }
+};
+
+struct SpiralCurve {
+  float max_radius, revolutions;
+  void at(float t, float& x, float& y) const {
+    float angle = -t * revolutions * 2.0f * (float)M_PI;
+    x = t * max_radius * cosf(angle);
+    y = t * max_radius * sinf(angle);
+  }
+};
+
+struct FlowerCurve {
+  float radius, amplitude;
+  int petals;
+  void at(float t, float& x, float& y) const {
+    float angle = 2.0f * (float)M_PI * t;
+    float r = radius + amplitude * sinf(petals * angle);
+    x = r * cosf(angle);
+    y = r * sinf(angle);
+  }
+};
+
+// ============================================================================
+// SUBDIVISION
+// ============================================================================
+
+/**
+ * @brief Pose at a curve point, chosen like the sketches' solvePlatformPoint()
+ *
+ * This is the greedy choice; a whole-pattern plan (BranchPlanner.h) agrees
+ * with it along smooth curves, which is what the check is for.
+ * @return false if the point has no pose (near the centre, out of reach)
+ */
+inline bool chordPose(const Solver& solver, float x, float y, bool have_previous, angle_t& lever, angle_t& platform) {
+  Solution solution;
+  if (solver.solve(x, y, solution) != SOLVED) {
+    return false;
+  }
+  uint8_t pick = chooseSolution(solution, lever, platform, !have_previous);
+  lever = solution.lever[pick];
+  platform = solution.platform[pick];
+  return true;
+}
+
+/**
+ * @brief Emit the points of a curve needed to stay within 'tolerance' mm
+ * @param segments Starting spans (enough to resolve the curve's shape - e.g. 4 per turn)
+ * @param sink Called as sink.point(x, y) for every point, in order, starting with t = 0
+ * @return Number of points emitted
+ */
+template <class Curve, class Sink>
+uint16_t subdivideChords(const Solver& solver, const Curve& curve, float tolerance, uint8_t segments, Sink& sink) {
+  if (segments == 0) {
+    segments = 1;
+  }
+
+  float x, y;
+  curve.at(0.0f, x, y);
+  sink.point(x, y);
+  uint16_t emitted = 1;
+
+  angle_t lever = 0;
+  angle_t platform = 0;
+  bool have_pose = chordPose(solver, x, y, false, lever, platform);
+  float t0 = 0.0f;
+
+  for (uint8_t s = 1; s <= segments; s++) {
+    // Pending span ends, nearest last; depth of each
+    float ends[CHORD_MAX_DEPTH + 1];
+    uint8_t depth[CHORD_MAX_DEPTH + 1];
+    uint8_t pending = 1;
+    ends[0] = (float)s / segments;
+    depth[0] = 0;
+
+    while (pending > 0) {
+      float t1 = ends[pending - 1];
+      float x1, y1;
+      curve.at(t1, x1, y1);
+
+      angle_t lever1 = lever;
+      angle_t platform1 = platform;
+      bool solved = chordPose(solver, x1, y1, have_pose, lever1, platform1);
+
+      // Where the interpolated pose halfway along puts the stylus, against the curve
+      bool split = false;
+      float tm = 0.5f * (t0 + t1);
+      if (solved && have_pose && depth[pending - 1] < CHORD_MAX_DEPTH) {
+        float fx, fy, cx, cy;
+        solver.forward(lever + wrapHalfTurn(lever1 - lever) / 2, platform + wrapHalfTurn(platform1 - platform) / 2,
+                       fx, fy);
+        curve.at(tm, cx, cy);
+        solver.clampToPlatform(cx, cy);
+        split = (fx - cx) * (fx - cx) + (fy - cy) * (fy - cy) > tolerance * tolerance;
+      }
+
+      if (split) {
+        ends[pending] = tm;
+        depth[pending] = depth[pending - 1] + 1;
+        pending++;
+        continue;
+      }
+
+      pending--;
+      sink.point(x1, y1);
+      emitted++;
+      t0 = t1;
+      if (solved) {
+        lever = lever1;
+        platform = platform1;
+        have_pose = true;
+      }
+    }
+  }
+  return emitted;
+}
+
+}  // namespace PolarKinematics
+
+#endif // CHORD_SUBDIVISION_H
@@ -0,0 +1,590 @@
+/**
+ * @file PolarKinematics.h
+ * @brief Inverse kinematics of the polar arm + rotating platform, in fixed point
+ *
+ * The stylus sits on the end of a rigid arm that swings about the origin; the
+ * dish rotates about (Cx, Cy). Reaching a point on the dish means finding
+ * where the arm's circle meets the circle the point sweeps as the platform
+ * turns, then turning the platform to bring the point there.
+ *
+ * The SAMD21 has no FPU, so the solver runs in Q16.16 millimetres with an
+ * integer square root and a CORDIC atan2. Everything that only depends on
+ * the geometry (centre distance, its reciprocal, the unit vector to the
+ * platform centre, reach limits) is folded at compile time by the constexpr
+ * Solver constructor. solveFloat() is the original floating-point solution,
+ * kept as a reference to validate against.
+ *
+ * Angles are binary angles: 65536 = one turn, so an encoder tick (4096 per
+ * turn) is 16 units and wrapping is a mask.
+ *
+ * Header-only; shared by PetriStreaker, PetriStreakerSerial and DoublePolarArm.
+ */
+
+#ifndef POLAR_KINEMATICS_H
+#define POLAR_KINEMATICS_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+namespace PolarKinematics {
+
+typedef int32_t q16_t;    // 16.16 fixed point (millimetres)
+typedef int32_t angle_t;  // Binary angle, 65536 = one turn
+
+const angle_t TURN = 65536;
+const angle_t HALF_TURN = 32768;
+const uint8_t ANGLE_TO_TICK_SHIFT = 4;  // 65536 / 4096 (X-series encoder)
+
+// ============================================================================
+// COMPILE-TIME HELPERS
+// ============================================================================
+
+constexpr q16_t toQ16(double value) {
+  return (q16_t)(value * 65536.0 + (value >= 0 ? 0.5 : -0.5));
+}
+
+constexpr int64_t toQ16Wide(double value) {
+  return (int64_t)(value * 65536.0 + (value >= 0 ? 0.5 : -0.5));
+}
+
+constexpr double newtonSqrt(double x, double guess, int steps) {
+  return steps == 0 ? guess : newtonSqrt(x, 0.5 * (guess + x / guess), steps - 1);
+}
+
+constexpr double constSqrt(double x) {
+  return x <= 0.0 ? 0.0 : newtonSqrt(x, x > 1.0 ? x : 1.0, 48);
+}
+
+constexpr double constAbs(double x) {
+  return x < 0.0 ? -x : x;
+}
+
+constexpr double constMax(double a, double b) {
+  return a > b ? a : b;
+}
+
+// ============================================================================
+// COMPILE-TIME TRIGONOMETRY
+// ============================================================================
+// Series evaluations for constexpr use (pattern tables); never run on the board.
+
+constexpr double CONST_PI = 3.14159265358979323846;
+
+constexpr double reduceAngle(double x) {
+  return x - 2.0 * CONST_PI * (double)(long long)((x + (x >= 0.0 ? CONST_PI : -CONST_PI)) / (2.0 * CONST_PI));
+}
+
+constexpr double sinTerms(double x2, double term, double sum, int n) {
+  return n > 14 ? sum + term : sinTerms(x2, -term * x2 / ((2.0 * n) * (2.0 * n + 1.0)), sum + term, n + 1);
+}
+
+constexpr double constSinReduced(double x) {
+  return sinTerms(x * x, x, 0.0, 1);
+}
+
+constexpr double constSin(double x) {
+  return constSinReduced(reduceAngle(x));
+}
+
+constexpr double constCos(double x) {
+  return constSin(x + CONST_PI / 2.0);
+}
+
+constexpr double atanTerms(double x2, double power, double sum, int n) {
+  return n > 24 ? sum : atanTerms(x2, -power * x2, sum + power / (2.0 * n + 1.0), n + 1);
+}
+
+// atan(x) = 2 atan(x / (1 + sqrt(1 + x^2))); halving twice keeps the series short
+constexpr double atanHalve(double x) {
+  return x / (1.0 + constSqrt(1.0 + x * x));
+}
+
+constexpr double constAtanUnit(double x) {
+  return 4.0 * atanTerms(atanHalve(atanHalve(x)) * atanHalve(atanHalve(x)), atanHalve(atanHalve(x)), 0.0, 0);
+}
+
+constexpr double constAtanPositive(double x) {
+  return x > 1.0 ? CONST_PI / 2.0 - constAtanUnit(1.0 / x) : constAtanUnit(x);
+}
+
+constexpr double constAtan(double x) {
+  return x < 0.0 ? -constAtanPositive(-x) : constAtanPositive(x);
+}
+
+constexpr double constAtan2(double y, double x) {
+  return x > 0.0 ? constAtan(y / x)
+       : x < 0.0 ? (y >= 0.0 ? constAtan(y / x) + CONST_PI : constAtan(y / x) - CONST_PI)
+       : (y > 0.0 ? CONST_PI / 2.0 : (y < 0.0 ? -CONST_PI / 2.0 : 0.0));
+}
+
+constexpr int32_t roundToInt(double value) {
+  return (int32_t)(value + (value >= 0.0 ? 0.5 : -0.5));
+}
+
+// ============================================================================
+// FIXED-POINT PRIMITIVES
+// ============================================================================
+
+/**
+ * @brief Integer square root of a 64-bit value
+ */
+inline uint32_t isqrt64(uint64_t value) {
+  uint64_t result = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (value >= result + bit) {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)result;
+}
+
+/**
+ * @brief Square root of a Q16 value (given as a wide Q16 for headroom)
+ */
+inline q16_t sqrtQ16(int64_t value) {
+  return value <= 0 ? 0 : (q16_t)isqrt64((uint64_t)value << 16);
+}
+
+/**
+ * @brief atan2 by CORDIC vectoring, no floating point
+ * @return Binary angle in [-HALF_TURN, HALF_TURN]
+ */
+inline angle_t atan2Q16(q16_t y, q16_t x) {
+  // atan(2^-i) in 1/2^24 turn; the extra 8 bits keep rounding out of the result
+  static const int32_t ATAN_TABLE[20] = {
+    2097152, 1238021, 654136, 332050, 166669, 83416, 41718, 20860, 10430, 5215,
+    2608, 1304, 652, 326, 163, 81, 41, 20, 10, 5
+  };
+  if (x == 0 && y == 0) {
+    return 0;
+  }
+
+  // Rotate into the right half-plane first
+  int32_t angle = 0;
+  if (x < 0) {
+    angle = (y >= 0) ? (1 << 23) : -(1 << 23);
+    x = -x;
+    y = -y;
+  }
+
+  for (uint8_t i = 0; i < 20; i++) {
+    int32_t dx = x >> i;
+    int32_t dy = y >> i;
+    if (y > 0) {
+      x += dy;
+      y -= dx;
+      angle += ATAN_TABLE[i];
+    } else {
+      x -= dy;
+      y += dx;
+      angle -= ATAN_TABLE[i];
+    }
+  }
+  return (angle + 128) >> 8;
+}
+
+/**
+ * @brief Wrap a binary angle into [-HALF_TURN, HALF_TURN)
+ */
+constexpr angle_t wrapHalfTurn(angle_t angle) {
+  return (angle_t)(int16_t)(uint16_t)angle;
+}
+
+inline float toRadians(angle_t angle) {
+  return angle * (float)(2.0 * M_PI / TURN);
+}
+
+inline float toDegrees(angle_t angle) {
+  return angle * (360.0f / TURN);
+}
+
+inline angle_t fromRadians(float radians) {
+  return (angle_t)lroundf(radians * (float)(TURN / (2.0 * M_PI)));
+}
+
+/**
+ * @brief Encoder ticks (4096 per turn) of a binary angle, rounded
+ */
+constexpr int32_t toTicks(angle_t angle) {
+  return (angle + (1 << (ANGLE_TO_TICK_SHIFT - 1))) >> ANGLE_TO_TICK_SHIFT;
+}
+
+/**
+ * @brief Binary angle of an encoder tick count
+ */
+constexpr angle_t fromTicks(int32_t ticks) {
+  return ticks * (1 << ANGLE_TO_TICK_SHIFT);
+}
+
+// ============================================================================
+// SOLVER
+// ============================================================================
+
+/**
+ * @brief Both arm/platform solutions for one point
+ *
+ * Platform angles are the raw difference of two atan2 results, so they may
+ * lie anywhere in (-TURN, TURN) - callers that want a wrapped angle use
+ * wrapHalfTurn().
+ */
+struct Solution {
+  angle_t lever[2];     // Arm angle about the origin
+  angle_t platform[2];  // Platform rotation that brings the point under the stylus
+};
+
+enum Result {
+  SOLVED,
+  NEAR_CENTER,   // Closer to the platform centre than the solver's minimum radius
+  UNREACHABLE    // The arm cannot reach this radius
+};
+
+/**
+ * @brief Result and solution together, for the constexpr solver
+ */
+struct SolveResult {
+  Result result;
+  Solution solution;
+};
+
+/**
+ * @brief A point on the dish relative to its centre (mm), for the constexpr forward kinematics
+ */
+struct DishPoint {
+  double x;
+  double y;
+};
+
+class Solver {
+  public:
+    /**
+     * @param cx, cy Platform centre relative to the arm pivot (mm)
+     * @param arm_length Pivot to stylus (mm)
+     * @param platform_radius Points further out are pulled in to this radius (mm)
+     * @param min_radius Points closer to the centre are reported as NEAR_CENTER (mm)
+     */
+    constexpr Solver(double cx, double cy, double arm_length, double platform_radius, double min_radius = 0.0)
+      : cx(toQ16(cx)),
+        cy(toQ16(cy)),
+        plat_radius(toQ16(platform_radius)),
+        plat_radius_sq(toQ16Wide(platform_radius * platform_radius)),
+        min_radius_sq(toQ16Wide(min_radius * min_radius)),
+        arm_sq(toQ16Wide(arm_length * arm_length)),
+        a_numerator(toQ16Wide(arm_length * arm_length + cx * cx + cy * cy)),
+        inv_two_dist((int64_t)(4294967296.0 / (2.0 * constSqrt(cx * cx + cy * cy)) + 0.5)),
+        ux(toQ16(cx / constSqrt(cx * cx + cy * cy))),
+        uy(toQ16(cy / constSqrt(cx * cx + cy * cy))),
+        reach_min(toQ16(constAbs(constSqrt(cx * cx + cy * cy) - arm_length))),
+        reach_max(toQ16(constSqrt(cx * cx + cy * cy) + arm_length)),
+        cx_f((float)cx),
+        cy_f((float)cy),
+        arm_f((float)arm_length),
+        plat_radius_f((float)platform_radius),
+        min_radius_f((float)min_radius),
+        geo_cx(cx),
+        geo_cy(cy),
+        geo_arm(arm_length),
+        geo_plat(platform_radius),
+        geo_min(min_radius),
+        geo_dist(constSqrt(cx * cx + cy * cy)) {}
+
+    /**
+     * @brief Fixed-point solution of a platform point
+     * @param rx, ry Point on the dish relative to its centre, Q16 mm
+     */
+    Result solve(q16_t rx, q16_t ry, Solution& out) const {
+      int64_t r_sq = ((int64_t)rx * rx + (int64_t)ry * ry) >> 16;
+      if (r_sq < min_radius_sq) {
+        return NEAR_CENTER;
+      }
+
+      // Pull points outside the dish in to its edge
+      q16_t r;
+      if (r_sq > plat_radius_sq) {
+        r = sqrtQ16(r_sq);
+        rx = (q16_t)((int64_t)rx * plat_radius / r);
+        ry = (q16_t)((int64_t)ry * plat_radius / r);
+        r = plat_radius;
+        r_sq = plat_radius_sq;
+      } else {
+        r = sqrtQ16(r_sq);
+      }
+      if (r < reach_min || r > reach_max) {
+        return UNREACHABLE;
+      }
+
+      angle_t original = atan2Q16(ry, rx);
+
+      // Distance along the centre line to the chord, and half the chord
+      q16_t a = (q16_t)(((a_numerator - r_sq) * inv_two_dist) >> 32);
+      int64_t h_sq = arm_sq - (((int64_t)a * a) >> 16);
+      q16_t h = sqrtQ16(h_sq);
+
+      q16_t mid_x = (q16_t)(((int64_t)a * ux) >> 16);
+      q16_t mid_y = (q16_t)(((int64_t)a * uy) >> 16);
+      q16_t off_x = (q16_t)(((int64_t)h * uy) >> 16);
+      q16_t off_y = (q16_t)(((int64_t)h * ux) >> 16);
+
+      q16_t x1 = mid_x - off_x;
+      q16_t y1 = mid_y + off_y;
+      q16_t x2 = mid_x + off_x;
+      q16_t y2 = mid_y - off_y;
+
+      out.lever[0] = atan2Q16(y1, x1);
+      out.lever[1] = atan2Q16(y2, x2);
+      out.platform[0] = atan2Q16(y1 - cy, x1 - cx) - original;
+      out.platform[1] = atan2Q16(y2 - cy, x2 - cx) - original;
+      return SOLVED;
+    }
+
+    Result solve(float rx, float ry, Solution& out) const {
+      return solve((q16_t)lroundf(rx * 65536.0f), (q16_t)lroundf(ry * 65536.0f), out);
+    }
+
+    /**
+     * @brief Floating-point reference (the original circle-intersection code)
+     */
+    Result solveFloat(float rx, float ry, Solution& out) const {
+      float r = sqrtf(rx * rx + ry * ry);
+      if (r < min_radius_f) {
+        return NEAR_CENTER;
+      }
+      if (r > plat_radius_f) {
+        rx = (plat_radius_f / r) * rx;
+        ry = (plat_radius_f / r) * ry;
+        r = plat_radius_f;
+      }
+
+      float original = atan2f(ry, rx);
+      float center_dist = sqrtf(cx_f * cx_f + cy_f * cy_f);
+      if (center_dist > arm_f + r || center_dist < fabsf(arm_f - r)) {
+        return UNREACHABLE;
+      }
+
+      float a = (arm_f * arm_f - r * r + center_dist * center_dist) / (2.0f * center_dist);
+      float h = sqrtf(fmaxf(arm_f * arm_f - a * a, 0.0f));
+      float mid_x = cx_f * a / center_dist;
+      float mid_y = cy_f * a / center_dist;
+
+      float x1 = mid_x + h * (-cy_f) / center_dist;
+      float y1 = mid_y + h * cx_f / center_dist;
+      float x2 = mid_x - h * (-cy_f) / center_dist;
+      float y2 = mid_y - h * cx_f / center_dist;
+
+      out.lever[0] = fromRadians(atan2f(y1, x1));
+      out.lever[1] = fromRadians(atan2f(y2, x2));
+      out.platform[0] = fromRadians(atan2f(y1 - cy_f, x1 - cx_f) - original);
+      out.platform[1] = fromRadians(atan2f(y2 - cy_f, x2 - cx_f) - original);
+      return SOLVED;
+    }
+
+    /**
+     * @brief Where a pose puts the stylus, in dish coordinates (mm)
+     *
+     * The stylus sits at arm * (cos lever, sin lever); turning the platform
+     * back by 'platform' about its centre gives the dish point under it.
+     */
+    void forward(angle_t lever, angle_t platform, float& rx, float& ry) const {
+      float sx = arm_f * cosf(toRadians(lever)) - cx_f;
+      float sy = arm_f * sinf(toRadians(lever)) - cy_f;
+      float r = sqrtf(sx * sx + sy * sy);
+      float angle = atan2f(sy, sx) - toRadians(platform);
+      rx = r * cosf(angle);
+      ry = r * sinf(angle);
+    }
+
+    /**
+     * @brief Arm angle that puts the stylus over the platform centre
+     * @return false if the arm misses the centre by more than the minimum radius
+     */
+    bool centerLever(angle_t& lever) const {
+      if ((((int64_t)reach_min * reach_min) >> 16) > min_radius_sq) {
+        return false;
+      }
+      lever = atan2Q16(cy, cx);
+      return true;
+    }
+
+    /**
+     * @brief Direction of the stylus seen from the platform centre, for an arm angle
+     */
+    angle_t centerHeading(angle_t lever) const {
+      return fromRadians(atan2f(arm_f * sinf(toRadians(lever)) - cy_f, arm_f * cosf(toRadians(lever)) - cx_f));
+    }
+
+    float platformRadius() const {
+      return plat_radius_f;
+    }
+
+    /**
+     * @brief Pull a point outside the dish in to its edge, as solve() does
+     */
+    void clampToPlatform(float& rx, float& ry) const {
+      float r = sqrtf(rx * rx + ry * ry);
+      if (r > plat_radius_f) {
+        rx = (plat_radius_f / r) * rx;
+        ry = (plat_radius_f / r) * ry;
+      }
+    }
+
+    /**
+     * @brief Compile-time solution in double precision
+     *
+     * Same steps as solveFloat(), written as constexpr expressions so fixed
+     * patterns can be turned into joint tables by the compiler.
+     */
+    constexpr SolveResult solveConst(double rx, double ry) const {
+      return solveConstRadius(rx, ry, constSqrt(rx * rx + ry * ry));
+    }
+
+    /**
+     * @brief Compile-time forward(), in double precision
+     */
+    constexpr DishPoint forwardConst(angle_t lever, angle_t platform) const {
+      return forwardConstStylus(geo_arm * constCos(constToRadians(lever)) - geo_cx,
+                                geo_arm * constSin(constToRadians(lever)) - geo_cy, platform);
+    }
+
+    /**
+     * @brief Compile-time centerLever(): true if the arm passes within the minimum radius of the centre
+     */
+    constexpr bool reachesCenterConst() const {
+      return constAbs(geo_dist - geo_arm) <= geo_min;
+    }
+
+    constexpr angle_t centerLeverConst() const {
+      return constToAngle(constAtan2(geo_cy, geo_cx));
+    }
+
+    constexpr angle_t centerHeadingConst(angle_t lever) const {
+      return constToAngle(constAtan2(geo_arm * constSin(constToRadians(lever)) - geo_cy,
+                                     geo_arm * constCos(constToRadians(lever)) - geo_cx));
+    }
+
+    constexpr double platformRadiusConst() const {
+      return geo_plat;
+    }
+
+    /**
+     * @brief Arm angle either side of centerLeverConst() within which the stylus
+     *        is closer than 'distance' to the platform centre
+     */
+    constexpr angle_t centerBandConst(double distance) const {
+      return bandFromCos((geo_arm * geo_arm + geo_dist * geo_dist - distance * distance) / (2.0 * geo_arm * geo_dist));
+    }
+
+  private:
+    // Folded geometry, Q16 (the *_sq and a_numerator terms are mm^2)
+    q16_t cx;
+    q16_t cy;
+    q16_t plat_radius;
+    int64_t plat_radius_sq;
+    int64_t min_radius_sq;
+    int64_t arm_sq;
+    int64_t a_numerator;     // arm^2 + centre_dist^2
+    int64_t inv_two_dist;    // 2^32 / (2 * centre_dist)
+    q16_t ux;                // Unit vector pivot -> platform centre
+    q16_t uy;
+    q16_t reach_min;
+    q16_t reach_max;
+
+    // Same geometry for the float reference
+    float cx_f;
+    float cy_f;
+    float arm_f;
+    float plat_radius_f;
+    float min_radius_f;
+
+    // And in double precision for solveConst()
+    double geo_cx;
+    double geo_cy;
+    double geo_arm;
+    double geo_plat;
+    double geo_min;
+    double geo_dist;
+
+    constexpr SolveResult solveConstRadius(double rx, double ry, double r) const {
+      return r < geo_min ? SolveResult{NEAR_CENTER, Solution{{0, 0}, {0, 0}}}
+           : r > geo_plat ? solveConstReach(rx * geo_plat / r, ry * geo_plat / r, geo_plat)
+           : solveConstReach(rx, ry, r);
+    }
+
+    constexpr SolveResult solveConstReach(double rx, double ry, double r) const {
+      return (geo_dist > geo_arm + r || geo_dist < constAbs(geo_arm - r))
+           ? SolveResult{UNREACHABLE, Solution{{0, 0}, {0, 0}}}
+           : solveConstChord(constAtan2(ry, rx), (geo_arm * geo_arm - r * r + geo_dist * geo_dist) / (2.0 * geo_dist));
+    }
+
+    constexpr SolveResult solveConstChord(double original, double a) const {
+      return solveConstPoints(original, geo_cx * a / geo_dist, geo_cy * a / geo_dist,
+                              constSqrt(geo_arm * geo_arm - a * a) / geo_dist);
+    }
+
+    // h_scaled is half the chord divided by the centre distance
+    constexpr SolveResult solveConstPoints(double original, double mid_x, double mid_y, double h_scaled) const {
+      return SolveResult{SOLVED, Solution{
+        {constToAngle(constAtan2(mid_y + h_scaled * geo_cx, mid_x - h_scaled * geo_cy)),
+         constToAngle(constAtan2(mid_y - h_scaled * geo_cx, mid_x + h_scaled * geo_cy))},
+        {constToAngle(constAtan2(mid_y + h_scaled * geo_cx - geo_cy, mid_x - h_scaled * geo_cy - geo_cx) - original),
+         constToAngle(constAtan2(mid_y - h_scaled * geo_cx - geo_cy, mid_x + h_scaled * geo_cy - geo_cx) - original)}
+      }};
+    }
+
+    static constexpr angle_t constToAngle(double radians) {
+      return roundToInt(radians * (TURN / (2.0 * CONST_PI)));
+    }
+
+    static constexpr double constToRadians(angle_t angle) {
+      return angle * (2.0 * CONST_PI / TURN);
+    }
+
+    constexpr DishPoint forwardConstStylus(double sx, double sy, angle_t platform) const {
+      return forwardConstPolar(constSqrt(sx * sx + sy * sy), constAtan2(sy, sx) - constToRadians(platform));
+    }
+
+    static constexpr DishPoint forwardConstPolar(double r, double angle) {
+      return DishPoint{r * constCos(angle), r * constSin(angle)};
+    }
+
+    // Law of cosines about the pivot: cos of the arm angle away from the centre line
+    static constexpr angle_t bandFromCos(double c) {
+      return c >= 1.0 ? 0 : c <= -1.0 ? HALF_TURN : constToAngle(constAtan2(constSqrt(1.0 - c * c), c));
+    }
+};
+
+constexpr int32_t angleCost(angle_t angle) {
+  return angle < 0 ? -angle : angle;
+}
+
+/**
+ * @brief Pick the solution that moves the axes least
+ *
+ * On the first move of a pattern there is no current pose, so the one with
+ * the smaller platform rotation wins. Differences are wrapped to half a
+ * turn: the platform angle of the same branch jumps by a full turn where
+ * the point crosses the negative x axis, and the platform is unwrapped
+ * onto its multi-turn scale anyway.
+ * @return 0 or 1, index into the Solution arrays
+ */
+constexpr uint8_t chooseSolution(const Solution& solution, angle_t current_lever, angle_t current_platform,
+                                 bool first_move) {
+  return (first_move
+            ? angleCost(wrapHalfTurn(solution.platform[0])) <= angleCost(wrapHalfTurn(solution.platform[1]))
+            : angleCost(wrapHalfTurn(solution.lever[0] - current_lever)) +
+              angleCost(wrapHalfTurn(solution.platform[0] - current_platform)) <=
+              angleCost(wrapHalfTurn(solution.lever[1] - current_lever)) +
+              angleCost(wrapHalfTurn(solution.platform[1] - current_platform)))
+         ? 0 : 1;
+}
+
+}  // namespace PolarKinematics
+
+#endif // POLAR_KINEMATICS_H